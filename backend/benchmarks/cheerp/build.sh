@@ -1,6 +1,9 @@
 #!/bin/bash
 # Requires Cheerp installed: https://leaningtech.com/cheerp/
-# Run: cheerp-wasm -o ../../../public/benchmarks/cheerp/cheerp_benchmark.js cheerp_benchmark.cpp
+# Also builds the shared kernel suite (../kernels) via kernel_exports.h.
+# Run: cheerp-wasm -O3 -msimd128 -cheerp-linear-heap-size=256 -o ../../../public/benchmarks/cheerp/cheerp_benchmark.js cheerp_benchmark.cpp
+# -msimd128 enables the GEMM micro-kernel's vector path; the 2048x2048 GEMM
+# needs ~64 MB of linear heap (default 8 MB).
 
 if ! command -v cheerp-wasm &> /dev/null
 then
@@ -9,5 +12,6 @@ then
     exit 0
 fi
 
-cheerp-wasm -o ../../../public/benchmarks/cheerp/cheerp_benchmark.js cheerp_benchmark.cpp
+cheerp-wasm -O3 -msimd128 -cheerp-linear-heap-size=256 \
+  -o ../../../public/benchmarks/cheerp/cheerp_benchmark.js cheerp_benchmark.cpp
 echo "Cheerp WASM built to public/benchmarks/cheerp"
@@ -1,19 +1,77 @@
 #include <cheerp/client.h>
 
+#include <cstdio>
+
+#include "../../experiments/common/bench_harness.h"
+#include "../../experiments/common/gemm.h"
+#include "../kernels/kernel_exports.h"
+
 [[cheerp::jsexport]]
 int fibonacci(int n) {
     if (n <= 1) return n;
     return fibonacci(n - 1) + fibonacci(n - 2);
 }
 
+// size x size single-precision GEMM on deterministic inputs (blocked, SIMD
+// where available). Returns the checksum of C so the work is observable.
+[[cheerp::jsexport]]
+double matrix_multiply(int size) {
+    GemmMatrix a(size, size), b(size, size), c(size, size);
+    gemm_fill(a, 1);
+    gemm_fill(b, 2);
+    gemm_blocked(a, b, c, true);
+    return gemm_checksum(c);
+}
+
+// Reference i-j-k version of matrix_multiply: same inputs, same checksum up
+// to rounding
+[[cheerp::jsexport]]
+double matrix_multiply_naive(int size) {
+    GemmMatrix a(size, size), b(size, size), c(size, size);
+    gemm_fill(a, 1);
+    gemm_fill(b, 2);
+    gemm_naive(a, b, c);
+    return gemm_checksum(c);
+}
+
+// --- GEMM Benchmark ---
+const int GEMM_SIZES[] = {64, 128, 256, 512, 1024, 2048};
+const int GEMM_NAIVE_MAX_SIZE = 512; // The i-j-k loop takes minutes beyond this
+
+// Times the blocked kernel (and the naive one up to GEMM_NAIVE_MAX_SIZE) on
+// preallocated matrices; opsPerSec is FLOP/s
+void bench_gemm(int n) {
+    GemmMatrix a(n, n), b(n, n), c(n, n), ref(n, n);
+    gemm_fill(a, 1);
+    gemm_fill(b, 2);
+
+    BenchConfig cfg;
+    cfg.warmup = 1;
+    cfg.min_reps = 3;
+    cfg.max_time_ms = 4000;
+    cfg.ops_per_rep = gemm_flops(a, b);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "cheerp/gemm-blocked(%d)", n);
+    BenchReport blocked = bench_run_timed(name, [&] { gemm_blocked(a, b, c, true); }, cfg);
+    bench_print(blocked);
+    std::printf("[%s] %.2f GFLOP/s, checksum %.6g\n", name, cfg.ops_per_rep / (blocked.stats.median * 1e6), gemm_checksum(c));
+
+    if (n > GEMM_NAIVE_MAX_SIZE) return;
+    std::snprintf(name, sizeof(name), "cheerp/gemm-naive(%d)", n);
+    BenchReport naive = bench_run_timed(name, [&] { gemm_naive(a, b, ref); }, cfg);
+    bench_print(naive);
+    std::printf("[%s] %.2f GFLOP/s, blocked is %.1fx faster, max |diff| %.3g\n", name,
+                cfg.ops_per_rep / (naive.stats.median * 1e6), naive.stats.median / blocked.stats.median,
+                gemm_max_abs_diff(c, ref));
+}
+
+// Times each kernel with the shared harness; RESULT: lines go to the console.
+// The cross-toolchain kernel suite is separate: run_kernel_suite().
 [[cheerp::jsexport]]
-void matrix_multiply(int size) {
-    int a[size][size], b[size][size], c[size][size] = {0};
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            for (int k = 0; k < size; k++) {
-                c[i][j] += a[i][k] * b[k][j];
-            }
-        }
-    }
+void run_benchmarks() {
+    volatile int sink = 0;
+    bench_print(bench_run_timed("cheerp/fibonacci(25)", [&] { sink = fibonacci(25); }));
+    (void)sink;
+    for (int n : GEMM_SIZES) bench_gemm(n);
 }
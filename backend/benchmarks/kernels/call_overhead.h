@@ -0,0 +1,226 @@
+#pragma once
+// Fibonacci call-overhead family for the toolchain comparison.
+//
+// Plain recursive fib(n) mostly measures call lowering, and compilers are free
+// to constant-fold it or turn one of its calls into a loop. So each variant
+// here computes the same fib(n) a different way, which lets a toolchain's score
+// be split into call cost and arithmetic:
+//
+//   recursive    direct self-calls (call/return lowering)
+//   stack        the same call tree on an explicit stack, no calls at all
+//   indirect     recursion through a function pointer the compiler cannot see
+//   virtual      recursion through a virtual method on an opaque object
+//   boundary     every call crosses wasm <-> JS (call_boundary_hop, see
+//                kernel_exports.h; a plain indirect call in native builds)
+//   memoised     recursion with a memo table, n + 1 evaluations
+//   iterative    the two-variable loop
+//   table        a lookup in a constexpr table built at compile time
+//
+// Anti-folding barriers: n enters through a volatile (call_opaque), each
+// recursive call is noinline, and results land in a volatile sink. The virtual
+// variant reaches its object through volatile base pointers and its eval is
+// noinline too. Otherwise GCC speculatively devirtualises the lone override:
+// it compares the vtable slot and inlines the expected target several levels
+// deep, so "virtual" beats direct recursion. Native GCC builds of the suite
+// also pass -fno-devirtualize-speculatively as a backstop
+// (backend/experiments/CMakeLists.txt). The tree
+// variants report ns per node visited (2 * fib(n + 1) - 1 per evaluation),
+// the others ns per evaluation.
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "../../experiments/common/bench_harness.h"
+
+#if defined(__GNUC__)
+#define CALL_NOINLINE __attribute__((noinline))
+#else
+#define CALL_NOINLINE
+#endif
+
+const int CALL_FIB_N = 25;          // 242785 nodes per evaluation
+const int CALL_BOUNDARY_FIB_N = 18; // 8361 nodes; each one is a JS round trip
+const int CALL_FAST_BATCH = 4096;   // Evaluations per repetition for the O(n) / O(1) variants
+
+inline volatile int& call_barrier() {
+    static volatile int zero = 0;
+    return zero;
+}
+
+// `n` as a value the optimiser cannot see through
+inline int call_opaque(int n) {
+    return n + call_barrier();
+}
+
+inline double call_tree_nodes(int n) {
+    double a = 0, b = 1;    // fib(0), fib(1)
+    for (int i = 0; i <= n; i++) {
+        double t = a + b;
+        a = b;
+        b = t;
+    }
+    return 2.0 * a - 1.0;   // a = fib(n + 1)
+}
+
+// --- Variants ---
+CALL_NOINLINE inline int fib_recursive(int n) {
+    if (n <= 1) return n;
+    return fib_recursive(n - 1) + fib_recursive(n - 2);
+}
+
+// Visits the same tree as fib_recursive, with a heap stack instead of frames
+inline int fib_stack(int n, std::vector<int>& stack) {
+    int sum = 0;
+    stack.clear();
+    stack.push_back(n);
+    while (!stack.empty()) {
+        int k = stack.back();
+        stack.pop_back();
+        if (k <= 1) {
+            sum += k;
+        } else {
+            stack.push_back(k - 1);
+            stack.push_back(k - 2);
+        }
+    }
+    return sum;
+}
+
+typedef int (*CallFibFn)(int);
+
+CALL_NOINLINE inline int fib_indirect(int n) {
+    static CallFibFn volatile self = fib_indirect;
+    if (n <= 1) return n;
+    CallFibFn fn = self;
+    return fn(n - 1) + fn(n - 2);
+}
+
+struct CallFibNode {
+    virtual ~CallFibNode() {}
+    virtual int eval(int n) const = 0;
+};
+
+struct CallFibRecursive : CallFibNode {
+    const CallFibNode* self = this;
+    CALL_NOINLINE int eval(int n) const override {
+        if (n <= 1) return n;
+        const CallFibNode* next = *(const CallFibNode* const volatile*)&self;
+        return next->eval(n - 1) + next->eval(n - 2);
+    }
+};
+
+// Defined by the toolchain layer (kernel_exports.h): calls fib_boundary(n)
+// from the other side of the wasm <-> JS boundary
+int call_boundary_hop(int n);
+
+CALL_NOINLINE inline int fib_boundary(int n) {
+    if (n <= 1) return n;
+    return call_boundary_hop(n - 1) + call_boundary_hop(n - 2);
+}
+
+CALL_NOINLINE inline int fib_memo_step(int n, int* memo) {
+    if (memo[n] >= 0) return memo[n];
+    int v = n <= 1 ? n : fib_memo_step(n - 1, memo) + fib_memo_step(n - 2, memo);
+    memo[n] = v;
+    return v;
+}
+
+inline int fib_memoised(int n) {
+    int memo[64];
+    for (int i = 0; i <= n; i++) memo[i] = -1;
+    return fib_memo_step(n, memo);
+}
+
+inline int fib_iterative(int n) {
+    int a = 0, b = 1;
+    for (int i = 0; i < n; i++) {
+        int t = a + b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+struct CallFibTable {
+    int v[47];
+    constexpr CallFibTable() : v() {
+        v[1] = 1;
+        for (int i = 2; i < 47; i++) v[i] = v[i - 1] + v[i - 2];
+    }
+};
+constexpr CallFibTable CALL_FIB_TABLE;
+static_assert(CALL_FIB_TABLE.v[CALL_FIB_N] == 75025, "constexpr fib table");
+
+// --- Benchmark ---
+enum CallVariantKind { CallRecursive, CallStack, CallIndirect, CallVirtual, CallBoundary, CallMemoised, CallIterative, CallTable };
+
+struct CallVariant {
+    CallVariantKind kind;
+    const char* name;
+    int n;
+    int batch;          // Evaluations per repetition
+    bool tree;          // ops = nodes visited rather than evaluations
+};
+
+template <typename Fn>
+int64_t call_batch(int n, int batch, Fn&& fn) {
+    int64_t sum = 0;
+    for (int i = 0; i < batch; i++) sum += fn(call_opaque(n));
+    return sum;
+}
+
+// Runs one variant `batch` times on opaque inputs; returns the summed result
+inline int64_t call_run_variant(const CallVariant& v) {
+    static std::vector<int> stack;
+    static CallFibRecursive node;
+    static const CallFibNode* volatile opaqueRoot = &node;
+    const CallFibNode* root = opaqueRoot;
+    switch (v.kind) {
+        case CallRecursive: return call_batch(v.n, v.batch, fib_recursive);
+        case CallStack: return call_batch(v.n, v.batch, [](int n) { return fib_stack(n, stack); });
+        case CallIndirect: return call_batch(v.n, v.batch, fib_indirect);
+        case CallVirtual: return call_batch(v.n, v.batch, [&](int n) { return root->eval(n); });
+        case CallBoundary: return call_batch(v.n, v.batch, fib_boundary);
+        case CallMemoised: return call_batch(v.n, v.batch, fib_memoised);
+        case CallIterative: return call_batch(v.n, v.batch, fib_iterative);
+        case CallTable: return call_batch(v.n, v.batch, [](int n) { return CALL_FIB_TABLE.v[n]; });
+    }
+    return 0;
+}
+
+// Benchmarks every variant as "<toolchain>/call/<variant>(n)" and checks each
+// result against the constexpr table. Returns the number of wrong results.
+inline int call_overhead_run(const char* toolchain) {
+    static const CallVariant variants[] = {
+        {CallRecursive, "recursive", CALL_FIB_N, 1, true},
+        {CallStack, "stack", CALL_FIB_N, 1, true},
+        {CallIndirect, "indirect", CALL_FIB_N, 1, true},
+        {CallVirtual, "virtual", CALL_FIB_N, 1, true},
+        {CallBoundary, "boundary", CALL_BOUNDARY_FIB_N, 1, true},
+        {CallMemoised, "memoised", CALL_FIB_N, CALL_FAST_BATCH, false},
+        {CallIterative, "iterative", CALL_FIB_N, CALL_FAST_BATCH, false},
+        {CallTable, "table", CALL_FIB_N, CALL_FAST_BATCH, false},
+    };
+    int failures = 0;
+    double recursiveNs = 0;
+    for (const CallVariant& v : variants) {
+        char name[96];
+        std::snprintf(name, sizeof(name), "%s/call/%s(%d)", toolchain, v.name, v.n);
+        BenchConfig cfg;
+        cfg.ops_per_rep = v.batch * (v.tree ? call_tree_nodes(v.n) : 1.0);
+        volatile int64_t sink = 0;
+        BenchReport r = bench_run_timed(name, [&] { sink = call_run_variant(v); }, cfg);
+        bench_print(r);
+
+        bool ok = sink == (int64_t)v.batch * CALL_FIB_TABLE.v[v.n];
+        if (!ok) failures++;
+        double ns = r.stats.median * 1e6 / cfg.ops_per_rep;
+        if (v.kind == CallRecursive) recursiveNs = ns;
+        std::printf("[%s] %.3f ns per %s%s", name, ns, v.tree ? "call" : "evaluation", ok ? "" : " (WRONG RESULT)");
+        if (v.tree && recursiveNs > 0) std::printf(", %.2fx recursive", ns / recursiveNs);
+        std::printf("\n");
+    }
+    std::fflush(stdout);
+    return failures;
+}
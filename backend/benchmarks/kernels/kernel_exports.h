@@ -0,0 +1,99 @@
+#pragma once
+// Entry points of the shared kernel suite, identical in every toolchain build.
+// Include from exactly one translation unit per build: cheerp_benchmark.cpp
+// (Cheerp), wasm/kernel_benchmark.cpp (Emscripten and the native kernel_suite
+// target).
+//
+//   kernel_count()          number of kernels
+//   kernel_name(id)         "gemm", "fft", ... (not exported to JS by Cheerp)
+//   kernel_run(id)          one run on the fixed input; returns the checksum
+//   kernel_check(id)        1 if kernel_run(id) matches the reference checksum
+//   run_kernel_suite()      benchmarks all kernels, RESULT: lines to stdout
+//   run_call_overhead()     benchmarks the Fibonacci call-overhead family
+
+#include "call_overhead.h"
+#include "kernel_suite.h"
+
+#if defined(__CHEERP__)
+#define KERNEL_EXPORT [[cheerp::jsexport]]
+#define KERNEL_TOOLCHAIN "cheerp"
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#define KERNEL_EXPORT extern "C" EMSCRIPTEN_KEEPALIVE
+#define KERNEL_TOOLCHAIN "emscripten"
+#else
+#define KERNEL_EXPORT extern "C"
+#define KERNEL_TOOLCHAIN "native"
+#endif
+
+// --- Call Boundary ---
+// call_overhead.h's fib_boundary() recurses through JS: wasm calls a JS
+// function that calls straight back into wasm
+#if defined(__CHEERP__)
+[[cheerp::genericjs]] int call_boundary_js(int n) {
+    return fib_boundary(n);
+}
+
+int call_boundary_hop(int n) {
+    return call_boundary_js(n);
+}
+#elif defined(__EMSCRIPTEN__)
+extern "C" EMSCRIPTEN_KEEPALIVE int call_fib_boundary(int n) {
+    return fib_boundary(n);
+}
+
+EM_JS(int, call_boundary_js, (int n), { return _call_fib_boundary(n); });
+
+int call_boundary_hop(int n) {
+    return call_boundary_js(n);
+}
+#else
+// No JS to cross natively: an opaque indirect call stands in
+int call_boundary_hop(int n) {
+    static CallFibFn volatile fn = fib_boundary;
+    return fn(n);
+}
+#endif
+
+// --- Entry Points ---
+// Runs each kernel's setup() once, on first use
+inline const KernelInfo* kernel_prepared(int id) {
+    static std::vector<bool> ready;
+    const std::vector<KernelInfo>& kernels = kernel_registry();
+    if (id < 0 || id >= (int)kernels.size()) return nullptr;
+    ready.resize(kernels.size());
+    if (!ready[id]) {
+        kernels[id].setup();
+        ready[id] = true;
+    }
+    return &kernels[id];
+}
+
+KERNEL_EXPORT int kernel_count() {
+    return (int)kernel_registry().size();
+}
+
+#if !defined(__CHEERP__)
+KERNEL_EXPORT const char* kernel_name(int id) {
+    const KernelInfo* k = kernel_prepared(id);
+    return k ? k->name : "";
+}
+#endif
+
+KERNEL_EXPORT double kernel_run(int id) {
+    const KernelInfo* k = kernel_prepared(id);
+    return k ? k->run() : std::nan("");
+}
+
+KERNEL_EXPORT int kernel_check(int id) {
+    const KernelInfo* k = kernel_prepared(id);
+    return k && kernel_checksum_ok(*k, k->run()) ? 1 : 0;
+}
+
+KERNEL_EXPORT void run_kernel_suite() {
+    kernel_suite_run(KERNEL_TOOLCHAIN);
+}
+
+KERNEL_EXPORT void run_call_overhead() {
+    call_overhead_run(KERNEL_TOOLCHAIN);
+}
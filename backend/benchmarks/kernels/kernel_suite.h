@@ -0,0 +1,615 @@
+#pragma once
+// Shared kernel suite for the toolchain comparison.
+//
+// One header-only set of kernels, compiled unchanged by Cheerp, Emscripten and
+// the native build (see kernel_exports.h for the entry points), so per-toolchain
+// numbers compare compilers rather than implementations. Every kernel has a
+// fixed, generated input (built by setup(), untimed) and returns a checksum of
+// its output, which also keeps the work observable. The checksums are checked
+// against reference values. Integer kernels must match exactly; floating-point
+// ones within a relative tolerance, since libm twiddles and FMA contraction may
+// differ between toolchains.
+//
+// The kernels are plain single-threaded C++ with no intrinsics, and each uses
+// its own code rather than the standard library's algorithms (std::sort,
+// std::unordered_map), because those differ between libc++ and libstdc++.
+// GEMM reuses common/gemm.h, whose vector-extension path follows the
+// toolchain's SIMD flag.
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../../experiments/common/bench_harness.h"
+#include "../../experiments/common/gemm.h"
+
+// --- Helpers ---
+inline uint32_t kernel_lcg(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state;
+}
+
+// Uniform in [-1, 1)
+inline double kernel_unit(uint32_t& state) {
+    return (double)(kernel_lcg(state) >> 8) * (2.0 / 16777216.0) - 1.0;
+}
+
+inline uint64_t kernel_fnv(uint64_t h, uint64_t v) {
+    return (h ^ v) * 1099511628211ull;
+}
+
+const uint64_t KERNEL_FNV_SEED = 1469598103934665603ull;
+
+// Integer checksums are folded to 32 bits so they survive the trip through a
+// double (and JS) exactly
+inline double kernel_fold(uint64_t h) {
+    return (double)(uint32_t)(h ^ (h >> 32));
+}
+
+// --- GEMM ---
+// 256 x 256 single-precision C = A * B, blocked, one thread
+const int GEMM_KERNEL_N = 256;
+
+struct GemmKernel {
+    GemmMatrix a{GEMM_KERNEL_N, GEMM_KERNEL_N};
+    GemmMatrix b{GEMM_KERNEL_N, GEMM_KERNEL_N};
+    GemmMatrix c{GEMM_KERNEL_N, GEMM_KERNEL_N};
+
+    void setup() {
+        gemm_fill(a, 1);
+        gemm_fill(b, 2);
+    }
+
+    double run() {
+        gemm_blocked(a, b, c, false);
+        return gemm_checksum(c);
+    }
+};
+
+// --- FFT ---
+// In-place iterative radix-2 complex FFT, 2^16 points, double precision
+const int FFT_KERNEL_LOG2 = 16;
+
+struct FftKernel {
+    std::vector<double> input;      // Interleaved re, im
+    std::vector<double> work;
+    std::vector<double> twiddles;   // cos, -sin of 2*pi*k/N for k < N/2
+    std::vector<uint32_t> reversed;
+
+    void setup() {
+        const uint32_t n = 1u << FFT_KERNEL_LOG2;
+        uint32_t state = 3;
+        input.resize(2 * n);
+        for (double& v : input) v = kernel_unit(state);
+        work.resize(2 * n);
+
+        twiddles.resize(n);
+        const double pi = 3.14159265358979323846;
+        for (uint32_t k = 0; k < n / 2; k++) {
+            twiddles[2 * k] = std::cos(2.0 * pi * k / n);
+            twiddles[2 * k + 1] = -std::sin(2.0 * pi * k / n);
+        }
+
+        reversed.resize(n);
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t r = 0;
+            for (int b = 0; b < FFT_KERNEL_LOG2; b++) r |= ((i >> b) & 1u) << (FFT_KERNEL_LOG2 - 1 - b);
+            reversed[i] = r;
+        }
+    }
+
+    double run() {
+        const uint32_t n = 1u << FFT_KERNEL_LOG2;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t r = reversed[i];
+            work[2 * r] = input[2 * i];
+            work[2 * r + 1] = input[2 * i + 1];
+        }
+
+        for (uint32_t len = 2; len <= n; len <<= 1) {
+            uint32_t half = len >> 1;
+            uint32_t stride = n / len;
+            for (uint32_t start = 0; start < n; start += len) {
+                for (uint32_t j = 0; j < half; j++) {
+                    double wr = twiddles[2 * j * stride], wi = twiddles[2 * j * stride + 1];
+                    double* u = &work[2 * (start + j)];
+                    double* v = &work[2 * (start + j + half)];
+                    double tr = v[0] * wr - v[1] * wi;
+                    double ti = v[0] * wi + v[1] * wr;
+                    v[0] = u[0] - tr;
+                    v[1] = u[1] - ti;
+                    u[0] += tr;
+                    u[1] += ti;
+                }
+            }
+        }
+
+        double sum = 0.0;
+        for (uint32_t k = 0; k < n; k++) sum += work[2 * k] * (double)((k & 7) + 1) + work[2 * k + 1];
+        return sum / n;
+    }
+};
+
+// --- N-body ---
+// 512 softened gravitational bodies, 4 direct-sum steps, double precision
+const int NBODY_KERNEL_BODIES = 512;
+const int NBODY_KERNEL_STEPS = 4;
+
+struct NbodyKernel {
+    struct Body { double x, y, z, vx, vy, vz, mass; };
+    std::vector<Body> initial;
+    std::vector<Body> bodies;
+
+    void setup() {
+        uint32_t state = 4;
+        initial.resize(NBODY_KERNEL_BODIES);
+        for (Body& b : initial) {
+            b.x = kernel_unit(state);
+            b.y = kernel_unit(state);
+            b.z = kernel_unit(state);
+            b.vx = 0.01 * kernel_unit(state);
+            b.vy = 0.01 * kernel_unit(state);
+            b.vz = 0.01 * kernel_unit(state);
+            b.mass = 1.0 + 0.5 * kernel_unit(state);
+        }
+    }
+
+    double run() {
+        const double dt = 0.001, softening = 0.01;
+        bodies = initial;
+        const int n = (int)bodies.size();
+        for (int step = 0; step < NBODY_KERNEL_STEPS; step++) {
+            for (int i = 0; i < n; i++) {
+                double ax = 0.0, ay = 0.0, az = 0.0;
+                for (int j = 0; j < n; j++) {
+                    double dx = bodies[j].x - bodies[i].x;
+                    double dy = bodies[j].y - bodies[i].y;
+                    double dz = bodies[j].z - bodies[i].z;
+                    double d2 = dx * dx + dy * dy + dz * dz + softening;
+                    double inv = 1.0 / (d2 * std::sqrt(d2));
+                    double s = bodies[j].mass * inv;
+                    ax += dx * s;
+                    ay += dy * s;
+                    az += dz * s;
+                }
+                bodies[i].vx += ax * dt;
+                bodies[i].vy += ay * dt;
+                bodies[i].vz += az * dt;
+            }
+            for (Body& b : bodies) {
+                b.x += b.vx * dt;
+                b.y += b.vy * dt;
+                b.z += b.vz * dt;
+            }
+        }
+
+        double sum = 0.0;
+        for (const Body& b : bodies) sum += b.x + 2.0 * b.y + 3.0 * b.z + b.vx + b.vy + b.vz;
+        return sum;
+    }
+};
+
+// --- SpMV ---
+// CSR matrix, 65536 rows x 16 random columns; 4 chained y = A * x products
+const int SPMV_KERNEL_ROWS = 65536;
+const int SPMV_KERNEL_ROW_NNZ = 16;
+const int SPMV_KERNEL_ITERS = 4;
+
+struct SpmvKernel {
+    std::vector<uint32_t> rowStart, cols;
+    std::vector<double> values, x0, x, y;
+
+    void setup() {
+        uint32_t state = 5;
+        rowStart.resize(SPMV_KERNEL_ROWS + 1);
+        cols.resize((size_t)SPMV_KERNEL_ROWS * SPMV_KERNEL_ROW_NNZ);
+        values.resize(cols.size());
+        for (int r = 0; r <= SPMV_KERNEL_ROWS; r++) rowStart[r] = (uint32_t)r * SPMV_KERNEL_ROW_NNZ;
+        for (size_t i = 0; i < cols.size(); i++) {
+            cols[i] = kernel_lcg(state) % SPMV_KERNEL_ROWS;
+            values[i] = kernel_unit(state);
+        }
+        x0.resize(SPMV_KERNEL_ROWS);
+        for (double& v : x0) v = kernel_unit(state);
+        x.resize(SPMV_KERNEL_ROWS);
+        y.resize(SPMV_KERNEL_ROWS);
+    }
+
+    double run() {
+        x = x0;
+        for (int it = 0; it < SPMV_KERNEL_ITERS; it++) {
+            for (int r = 0; r < SPMV_KERNEL_ROWS; r++) {
+                double sum = 0.0;
+                for (uint32_t i = rowStart[r]; i < rowStart[r + 1]; i++) sum += values[i] * x[cols[i]];
+                y[r] = sum;
+            }
+            // Scale by an exact power of two to keep the values bounded
+            for (int r = 0; r < SPMV_KERNEL_ROWS; r++) x[r] = y[r] * 0.25;
+        }
+        double sum = 0.0;
+        for (double v : y) sum += v;
+        return sum;
+    }
+};
+
+// --- Hash Join ---
+// Build an open-addressing table from 65536 (key, payload) rows, then probe it
+// with 262144 keys, about half of which match
+const int HASHJOIN_KERNEL_BUILD = 65536;
+const int HASHJOIN_KERNEL_PROBE = 262144;
+const int HASHJOIN_KERNEL_TABLE_LOG2 = 17;     // Load factor 0.5
+
+struct HashJoinKernel {
+    std::vector<uint32_t> buildKeys, buildPayloads, probeKeys;
+    std::vector<uint32_t> tableKeys, tablePayloads;
+    std::vector<uint8_t> tableUsed;
+
+    static uint32_t slot(uint32_t key) {
+        return (key * 2654435761u) >> (32 - HASHJOIN_KERNEL_TABLE_LOG2);
+    }
+
+    void setup() {
+        uint32_t state = 6;
+        buildKeys.resize(HASHJOIN_KERNEL_BUILD);
+        buildPayloads.resize(HASHJOIN_KERNEL_BUILD);
+        for (int i = 0; i < HASHJOIN_KERNEL_BUILD; i++) {
+            buildKeys[i] = ((uint32_t)i * 2246822519u) ^ 0x5bd1e995u;  // Distinct: odd multiplier
+            buildPayloads[i] = kernel_lcg(state);
+        }
+        probeKeys.resize(HASHJOIN_KERNEL_PROBE);
+        for (int i = 0; i < HASHJOIN_KERNEL_PROBE; i++) {
+            uint32_t r = kernel_lcg(state);
+            probeKeys[i] = (i & 1) ? buildKeys[r % HASHJOIN_KERNEL_BUILD] : r;
+        }
+        const size_t size = (size_t)1 << HASHJOIN_KERNEL_TABLE_LOG2;
+        tableKeys.resize(size);
+        tablePayloads.resize(size);
+        tableUsed.resize(size);
+    }
+
+    double run() {
+        const uint32_t mask = (1u << HASHJOIN_KERNEL_TABLE_LOG2) - 1;
+        std::memset(tableUsed.data(), 0, tableUsed.size());
+        for (int i = 0; i < HASHJOIN_KERNEL_BUILD; i++) {
+            uint32_t s = slot(buildKeys[i]);
+            while (tableUsed[s]) s = (s + 1) & mask;
+            tableUsed[s] = 1;
+            tableKeys[s] = buildKeys[i];
+            tablePayloads[s] = buildPayloads[i];
+        }
+
+        uint64_t matches = 0, payloadSum = 0;
+        for (int i = 0; i < HASHJOIN_KERNEL_PROBE; i++) {
+            uint32_t key = probeKeys[i];
+            for (uint32_t s = slot(key); tableUsed[s]; s = (s + 1) & mask) {
+                if (tableKeys[s] == key) {
+                    matches++;
+                    payloadSum += tablePayloads[s];
+                    break;
+                }
+            }
+        }
+        return kernel_fold(kernel_fnv(kernel_fnv(KERNEL_FNV_SEED, matches), payloadSum));
+    }
+};
+
+// --- JSON Tokenise ---
+// Tokenises a generated ~1 MB JSON document (objects, arrays, escaped strings,
+// numbers, literals); the checksum hashes every token's type and length
+const int JSON_KERNEL_RECORDS = 6000;
+
+struct JsonKernel {
+    std::string doc;
+
+    void setup() {
+        uint32_t state = 7;
+        doc = "[";
+        char buf[256];
+        for (int i = 0; i < JSON_KERNEL_RECORDS; i++) {
+            uint32_t r = kernel_lcg(state);
+            std::snprintf(buf, sizeof(buf),
+                          "%s{\"id\":%d,\"name\":\"item_%u\",\"price\":%u.%02u,\"ratio\":-%ue-%u,"
+                          "\"tags\":[\"t%u\",\"t%u\",\"t%u\"],\"active\":%s,\"parent\":null,"
+                          "\"note\":\"line \\\"%u\\\"\\n\\tend \\u00e9\"}",
+                          i ? "," : "", i, r % 100000, (r >> 8) % 1000, r % 100, (r >> 4) % 10 + 1, (r >> 12) % 9 + 1,
+                          r % 7, (r >> 3) % 11, (r >> 6) % 13, (r & 64) ? "true" : "false", r);
+            doc += buf;
+        }
+        doc += "]";
+    }
+
+    enum Token { Punct = 1, String, Number, Literal, Error };
+
+    double run() {
+        const char* p = doc.data();
+        const char* end = p + doc.size();
+        uint64_t h = KERNEL_FNV_SEED, count = 0;
+        while (p < end) {
+            char ch = *p;
+            const char* start = p;
+            int type;
+            if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r') {
+                p++;
+                continue;
+            } else if (ch == '{' || ch == '}' || ch == '[' || ch == ']' || ch == ':' || ch == ',') {
+                type = Punct;
+                p++;
+            } else if (ch == '"') {
+                type = String;
+                p++;
+                while (p < end && *p != '"') {
+                    if (*p == '\\') p += (p + 1 < end && p[1] == 'u') ? 6 : 2;
+                    else p++;
+                }
+                p++;
+            } else if (ch == '-' || (ch >= '0' && ch <= '9')) {
+                type = Number;
+                if (*p == '-') p++;
+                while (p < end && *p >= '0' && *p <= '9') p++;
+                if (p < end && *p == '.') {
+                    p++;
+                    while (p < end && *p >= '0' && *p <= '9') p++;
+                }
+                if (p < end && (*p == 'e' || *p == 'E')) {
+                    p++;
+                    if (p < end && (*p == '+' || *p == '-')) p++;
+                    while (p < end && *p >= '0' && *p <= '9') p++;
+                }
+            } else if (ch == 't' || ch == 'f' || ch == 'n') {
+                type = Literal;
+                p += ch == 'f' ? 5 : 4;
+            } else {
+                type = Error;
+                p++;
+            }
+            if (p > end) p = end;
+            h = kernel_fnv(h, (uint64_t)type << 32 | (uint64_t)(p - start));
+            count++;
+        }
+        return kernel_fold(kernel_fnv(h, count));
+    }
+};
+
+// --- LZ Decompress ---
+// Decodes an LZ4-style block (token nibbles for literal / match length, 255
+// continuation bytes, 16-bit offsets, minimum match 4) of ~1 MB of generated
+// word text; the block is produced once by a greedy hash-chain-free compressor
+const int LZ_KERNEL_BYTES = 1 << 20;
+
+struct LzKernel {
+    std::vector<uint8_t> original, compressed, output;
+
+    static void put_length(std::vector<uint8_t>& out, size_t len) {
+        while (len >= 255) {
+            out.push_back(255);
+            len -= 255;
+        }
+        out.push_back((uint8_t)len);
+    }
+
+    static void emit(std::vector<uint8_t>& out, const uint8_t* lit, size_t litLen, size_t offset, size_t matchLen) {
+        size_t m = matchLen ? matchLen - 4 : 0;
+        out.push_back((uint8_t)((litLen < 15 ? litLen : 15) << 4 | (m < 15 ? m : 15)));
+        if (litLen >= 15) put_length(out, litLen - 15);
+        out.insert(out.end(), lit, lit + litLen);
+        if (!matchLen) return;
+        out.push_back((uint8_t)(offset & 0xff));
+        out.push_back((uint8_t)(offset >> 8));
+        if (m >= 15) put_length(out, m - 15);
+    }
+
+    static std::vector<uint8_t> compress(const std::vector<uint8_t>& in) {
+        std::vector<uint8_t> out;
+        std::vector<int32_t> table(1 << 14, -1);
+        size_t anchor = 0, i = 0, n = in.size();
+        while (i + 4 <= n) {
+            uint32_t seq;
+            std::memcpy(&seq, &in[i], 4);
+            uint32_t h = (seq * 2654435761u) >> 18;
+            int32_t cand = table[h];
+            table[h] = (int32_t)i;
+            if (cand >= 0 && i - cand <= 65535 && std::memcmp(&in[cand], &in[i], 4) == 0) {
+                size_t len = 4;
+                while (i + len < n && in[cand + len] == in[i + len]) len++;
+                emit(out, &in[anchor], i - anchor, i - cand, len);
+                i += len;
+                anchor = i;
+            } else {
+                i++;
+            }
+        }
+        emit(out, &in[anchor], n - anchor, 0, 0);
+        return out;
+    }
+
+    // Returns the number of bytes written
+    static size_t decompress(const uint8_t* src, size_t srcLen, uint8_t* dst) {
+        const uint8_t* end = src + srcLen;
+        uint8_t* out = dst;
+        while (src < end) {
+            uint8_t token = *src++;
+            size_t litLen = token >> 4;
+            if (litLen == 15) {
+                uint8_t b;
+                do { b = *src++; litLen += b; } while (b == 255);
+            }
+            std::memcpy(out, src, litLen);
+            out += litLen;
+            src += litLen;
+            if (src >= end) break;
+
+            size_t offset = src[0] | (size_t)src[1] << 8;
+            src += 2;
+            size_t matchLen = token & 15;
+            if (matchLen == 15) {
+                uint8_t b;
+                do { b = *src++; matchLen += b; } while (b == 255);
+            }
+            matchLen += 4;
+            const uint8_t* match = out - offset;
+            if (offset >= matchLen) {
+                std::memcpy(out, match, matchLen);
+                out += matchLen;
+            } else {
+                for (size_t k = 0; k < matchLen; k++) *out++ = match[k]; // Overlapping copy
+            }
+        }
+        return (size_t)(out - dst);
+    }
+
+    void setup() {
+        static const char* words[] = {"the ", "quick ", "brown ", "fox ", "jumps ", "over ", "lazy ", "dog ",
+                                      "wasm ", "kernel ", "buffer ", "compile ", "cheerp ", "emscripten ", "native ", "\n"};
+        uint32_t state = 8;
+        original.clear();
+        while (original.size() < (size_t)LZ_KERNEL_BYTES) {
+            uint32_t r = kernel_lcg(state);
+            const char* w = words[(r >> 12) & 15];
+            original.insert(original.end(), w, w + std::strlen(w));
+            if ((r & 255) == 0) {
+                // Occasional incompressible run
+                for (int k = 0; k < 32; k++) original.push_back((uint8_t)(kernel_lcg(state) >> 24));
+            }
+        }
+        original.resize(LZ_KERNEL_BYTES);
+        compressed = compress(original);
+        output.assign(original.size() + 64, 0);
+    }
+
+    double run() {
+        size_t n = decompress(compressed.data(), compressed.size(), output.data());
+        uint64_t h = kernel_fnv(KERNEL_FNV_SEED, n);
+        for (size_t i = 0; i < n; i += 61) h = kernel_fnv(h, output[i]);
+        return kernel_fold(h);
+    }
+};
+
+// --- Sort ---
+// Quicksort (median of three, insertion sort below 16) of 2^20 random 32-bit keys
+const int SORT_KERNEL_KEYS = 1 << 20;
+
+struct SortKernel {
+    std::vector<uint32_t> input, work;
+
+    static void insertion_sort(uint32_t* a, int n) {
+        for (int i = 1; i < n; i++) {
+            uint32_t v = a[i];
+            int j = i - 1;
+            while (j >= 0 && a[j] > v) {
+                a[j + 1] = a[j];
+                j--;
+            }
+            a[j + 1] = v;
+        }
+    }
+
+    static void quicksort(uint32_t* a, int n) {
+        while (n > 16) {
+            uint32_t x = a[0], y = a[n / 2], z = a[n - 1];
+            uint32_t pivot = x < y ? (y < z ? y : (x < z ? z : x)) : (x < z ? x : (y < z ? z : y));
+            int i = 0, j = n - 1;
+            while (i <= j) {
+                while (a[i] < pivot) i++;
+                while (a[j] > pivot) j--;
+                if (i <= j) {
+                    uint32_t t = a[i];
+                    a[i] = a[j];
+                    a[j] = t;
+                    i++;
+                    j--;
+                }
+            }
+            // Recurse into the smaller side, loop on the larger
+            if (j + 1 < n - i) {
+                quicksort(a, j + 1);
+                a += i;
+                n -= i;
+            } else {
+                quicksort(a + i, n - i);
+                n = j + 1;
+            }
+        }
+        insertion_sort(a, n);
+    }
+
+    void setup() {
+        uint32_t state = 9;
+        input.resize(SORT_KERNEL_KEYS);
+        for (uint32_t& v : input) v = kernel_lcg(state) ^ (kernel_lcg(state) >> 16);
+        work.resize(SORT_KERNEL_KEYS);
+    }
+
+    double run() {
+        work = input;
+        quicksort(work.data(), (int)work.size());
+        uint64_t h = KERNEL_FNV_SEED;
+        uint64_t unsorted = 0;
+        for (size_t i = 1; i < work.size(); i++) unsorted += work[i - 1] > work[i];
+        for (size_t i = 0; i < work.size(); i += 997) h = kernel_fnv(h, work[i]);
+        return kernel_fold(kernel_fnv(h, unsorted));
+    }
+};
+
+// --- Registry ---
+struct KernelInfo {
+    const char* name;
+    void (*setup)();
+    double (*run)();
+    double expected;    // Reference checksum (native x86-64 build)
+    double tolerance;   // Relative; 0 means exact
+};
+
+// One lazily constructed instance per kernel, shared by setup() and run()
+template <typename K>
+K& kernel_instance() {
+    static K k;
+    return k;
+}
+
+template <typename K> void kernel_setup_fn() { kernel_instance<K>().setup(); }
+template <typename K> double kernel_run_fn() { return kernel_instance<K>().run(); }
+
+inline const std::vector<KernelInfo>& kernel_registry() {
+    static const std::vector<KernelInfo> kernels = {
+        {"gemm", kernel_setup_fn<GemmKernel>, kernel_run_fn<GemmKernel>, 660.62403393117711, 1e-5},
+        {"fft", kernel_setup_fn<FftKernel>, kernel_run_fn<FftKernel>, -0.054660944009567086, 1e-9},
+        {"nbody", kernel_setup_fn<NbodyKernel>, kernel_run_fn<NbodyKernel>, 89.576613956439601, 1e-9},
+        {"spmv", kernel_setup_fn<SpmvKernel>, kernel_run_fn<SpmvKernel>, 80.809898225352512, 1e-9},
+        {"hash-join", kernel_setup_fn<HashJoinKernel>, kernel_run_fn<HashJoinKernel>, 2328382291.0, 0.0},
+        {"json-tokenise", kernel_setup_fn<JsonKernel>, kernel_run_fn<JsonKernel>, 1714655619.0, 0.0},
+        {"lz-decompress", kernel_setup_fn<LzKernel>, kernel_run_fn<LzKernel>, 129402882.0, 0.0},
+        {"sort", kernel_setup_fn<SortKernel>, kernel_run_fn<SortKernel>, 1028073649.0, 0.0},
+    };
+    return kernels;
+}
+
+inline bool kernel_checksum_ok(const KernelInfo& k, double checksum) {
+    if (k.tolerance == 0.0) return checksum == k.expected;
+    return std::fabs(checksum - k.expected) <= k.tolerance * std::fmax(1.0, std::fabs(k.expected));
+}
+
+// Sets up and benchmarks every kernel (or only `only`), printing
+// "<toolchain>/kernel/<name>" RESULT lines plus a checksum line per kernel.
+// Returns the number of checksum mismatches.
+inline int kernel_suite_run(const char* toolchain, const char* only = nullptr) {
+    int failures = 0;
+    for (const KernelInfo& k : kernel_registry()) {
+        if (only && std::strcmp(only, k.name) != 0) continue;
+        k.setup();
+        std::string name = std::string(toolchain) + "/kernel/" + k.name;
+        double checksum = 0.0;
+        BenchConfig cfg;
+        cfg.max_time_ms = 3000;
+        bench_print(bench_run_timed(name.c_str(), [&] { checksum = k.run(); }, cfg));
+        bool ok = kernel_checksum_ok(k, checksum);
+        if (!ok) failures++;
+        std::printf("[%s] checksum %.17g (%s, expected %.17g)\n", name.c_str(), checksum, ok ? "ok" : "MISMATCH", k.expected);
+        std::printf("RESULT: {\"name\":\"%s/checksum\",\"checksum\":%.17g,\"ok\":%s}\n", name.c_str(), checksum,
+                    ok ? "true" : "false");
+        std::fflush(stdout);
+    }
+    return failures;
+}
@@ -0,0 +1,20 @@
+#!/bin/bash
+# Requires Emscripten installed: https://emscripten.org/docs/getting_started/
+# Builds the shared kernel suite (../kernels) with the same flags as the
+# Cheerp build. main() is not run on load (INVOKE_RUN=0); call
+# Module._run_kernel_suite() or the individual kernel_* exports from JS.
+
+if ! command -v emcc &> /dev/null
+then
+    echo "emcc could not be found. Please install Emscripten to build the kernel suite."
+    echo "Falling back to simulated results."
+    exit 0
+fi
+
+mkdir -p ../../../public/benchmarks/wasm
+emcc -O3 -msimd128 -std=c++17 kernel_benchmark.cpp \
+  -s ALLOW_MEMORY_GROWTH=1 \
+  -s INVOKE_RUN=0 \
+  -s EXPORTED_RUNTIME_METHODS=ccall,cwrap,UTF8ToString \
+  -o ../../../public/benchmarks/wasm/kernel_benchmark.js
+echo "Emscripten WASM built to public/benchmarks/wasm"
@@ -0,0 +1,39 @@
+// Emscripten driver for the shared kernel suite (../kernels/kernel_suite.h).
+// The same file builds natively as the kernel_suite target of
+// backend/experiments/CMakeLists.txt, so the native, Emscripten and Cheerp
+// numbers come from one source.
+
+#include <cstdio>
+#include <string>
+
+#include "../kernels/kernel_exports.h"
+
+// Usage: kernel_benchmark [--kernel NAME] [--calls] [--list]
+//   --kernel NAME   run only one kernel (gemm, fft, nbody, spmv, hash-join,
+//                   json-tokenise, lz-decompress, sort)
+//   --calls         run only the Fibonacci call-overhead family
+//   --list          print the kernel names and exit
+// With no mode flag, runs the kernels then the call-overhead family. Exits
+// non-zero if any checksum or Fibonacci result is wrong.
+int main(int argc, char** argv) {
+    const char* only = nullptr;
+    bool callsOnly = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--kernel" && i + 1 < argc) {
+            only = argv[++i];
+        } else if (arg == "--calls") {
+            callsOnly = true;
+        } else if (arg == "--list") {
+            for (const KernelInfo& k : kernel_registry()) std::printf("%s\n", k.name);
+            return 0;
+        } else {
+            std::printf("Usage: %s [--kernel NAME] [--calls] [--list]\n", argv[0]);
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (callsOnly) return call_overhead_run(KERNEL_TOOLCHAIN) ? 1 : 0;
+    int failures = kernel_suite_run(KERNEL_TOOLCHAIN, only);
+    if (!only) failures += call_overhead_run(KERNEL_TOOLCHAIN);
+    return failures ? 1 : 0;
+}
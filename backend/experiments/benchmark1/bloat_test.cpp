@@ -1,10 +1,18 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
 #include <atomic>
+#include <cstdlib>
+#include <fstream>
 #include <emscripten/emscripten.h>
 #include <webgpu/webgpu.h>
 
+#include "../common/alloc_tracker.h"
+#include "../common/bench_harness.h"
+#include "../common/gpu_timer.h"
+#include "../common/trace.h"
+
 // Total operations we want to perform (approx 268 Million ops)
 const uint32_t TOTAL_WORK_ITEMS = 268435456;
 
@@ -13,19 +21,24 @@ WGPUQueue queue = nullptr;
 WGPUComputePipeline pipeline = nullptr;
 WGPUBuffer uniformBuffer = nullptr;
 WGPUBindGroup bindGroup = nullptr;
+WGPUBindGroupLayout bindGroupLayout = nullptr;
+WGPUPipelineLayout pipelineLayout = nullptr;
+WGPUBuffer indirectArgsBuffer = nullptr; // MAX_BATCH x (1, 1, 1) for DispatchWorkgroupsIndirect
+GpuTimer gpuTimer;                       // Timestamp queries, or queue callbacks as a fallback
 
 struct Uniforms {
     uint32_t loopsPerThread;
 };
 
 // --- WGSL Shader ---
+// WORKGROUP_SIZE is substituted per pipeline variant (see create_pipeline)
 const char* shaderSource = R"(
 struct Uniforms {
     loopsPerThread : u32,
 };
 @group(0) @binding(0) var<uniform> params : Uniforms;
 
-@compute @workgroup_size(64)
+@compute @workgroup_size(WORKGROUP_SIZE)
 fn main(@builtin(global_invocation_id) global_id : vec3<u32>) {
     var a : f32 = f32(global_id.x) * 0.1;
     var b : f32 = 0.5;
@@ -54,24 +67,47 @@ void onDeviceRequestEnded(WGPURequestDeviceStatus status, WGPUDevice inDevice, c
 void onAdapterRequestEnded(WGPURequestAdapterStatus status, WGPUAdapter adapter, const char* message, void* userdata) {
     if (status == WGPURequestAdapterStatus_Success) {
         WGPUDeviceDescriptor deviceDesc = {};
+        gpu_timer_request_features(adapter, deviceDesc);
         wgpuAdapterRequestDevice(adapter, &deviceDesc, onDeviceRequestEnded, nullptr);
+        wgpuAdapterRelease(adapter); // The device keeps what it needs
     } else {
         std::cout << "[setup] Failed to get adapter." << std::endl;
     }
 }
 
-bool createShaderAndPipeline() {
+// Compiles shaderSource with the given @workgroup_size. Every variant shares
+// pipelineLayout, so the one bind group works with all of them.
+WGPUComputePipeline create_pipeline(uint32_t workgroupSize) {
+    std::string source = shaderSource;
+    const std::string placeholder = "WORKGROUP_SIZE";
+    source.replace(source.find(placeholder), placeholder.size(), std::to_string(workgroupSize));
+
     // Create shader module
     WGPUShaderModuleWGSLDescriptor wgslDesc = {};
     wgslDesc.chain.sType = WGPUSType_ShaderModuleWGSLDescriptor;
-    wgslDesc.source = shaderSource;
+    wgslDesc.source = source.c_str();
 
     WGPUShaderModuleDescriptor smDesc = {};
     smDesc.nextInChain = reinterpret_cast<const WGPUChainedStruct*>(&wgslDesc);
 
     WGPUShaderModule module = wgpuDeviceCreateShaderModule(device, &smDesc);
-    if (!module) return false;
+    if (!module) return nullptr;
 
+    // Compute pipeline
+    WGPUProgrammableStageDescriptor computeStage = {};
+    computeStage.module = module;
+    computeStage.entryPoint = "main";
+
+    WGPUComputePipelineDescriptor cpDesc = {};
+    cpDesc.layout = pipelineLayout;
+    cpDesc.compute = computeStage;
+
+    WGPUComputePipeline variant = wgpuDeviceCreateComputePipeline(device, &cpDesc);
+    wgpuShaderModuleRelease(module);
+    return variant;
+}
+
+bool createShaderAndPipeline() {
     // Bind group layout
     WGPUBindGroupLayoutEntry bglEntries[1];
     bglEntries[0].binding = 0;
@@ -79,26 +115,19 @@ bool createShaderAndPipeline() {
     bglEntries[0].buffer.type = WGPUBufferBindingType_Uniform;
 
     WGPUBindGroupLayoutDescriptor bglDesc = {};
-    bglDesc.bindingCount = 1;
+    bglDesc.entryCount = 1;
     bglDesc.entries = bglEntries;
-    WGPUBindGroupLayout bgl = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
+    bindGroupLayout = wgpuDeviceCreateBindGroupLayout(device, &bglDesc);
 
     // Pipeline layout
     WGPUPipelineLayoutDescriptor plDesc = {};
     plDesc.bindGroupLayoutCount = 1;
-    plDesc.bindGroupLayouts = &bgl;
-    WGPUPipelineLayout pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
+    plDesc.bindGroupLayouts = &bindGroupLayout;
+    pipelineLayout = wgpuDeviceCreatePipelineLayout(device, &plDesc);
 
-    // Compute pipeline
-    WGPUProgrammableStageDescriptor computeStage = {};
-    computeStage.module = module;
-    computeStage.entryPoint = "main";
-
-    WGPUComputePipelineDescriptor cpDesc = {};
-    cpDesc.layout = pipelineLayout;
-    cpDesc.compute = computeStage;
-
-    pipeline = wgpuDeviceCreateComputePipeline(device, &cpDesc);
+    // Default variant used by the fixed scenarios
+    pipeline = create_pipeline(64);
+    if (!pipeline) return false;
 
     // Uniform buffer
     WGPUBufferDescriptor ubDesc = {};
@@ -114,19 +143,64 @@ bool createShaderAndPipeline() {
     entries[0].size = sizeof(Uniforms);
 
     WGPUBindGroupDescriptor bgDesc = {};
-    bgDesc.layout = bgl;
+    bgDesc.layout = bindGroupLayout;
     bgDesc.entryCount = 1;
     bgDesc.entries = entries;
     bindGroup = wgpuDeviceCreateBindGroup(device, &bgDesc);
 
-    // Release module and bgl/pipelineLayout (not strictly necessary here)
-    wgpuShaderModuleRelease(module);
-    wgpuBindGroupLayoutRelease(bgl);
-    wgpuPipelineLayoutRelease(pipelineLayout);
-
     return true;
 }
 
+// Encodes and submits one compute pass with `dispatches` dispatches of
+// (gridX, gridY, 1) using the given pipeline variant. `timed` adds the
+// gpuTimer timestamp writes to the pass.
+void submit_dispatch(WGPUComputePipeline variant, uint32_t gridX, uint32_t gridY, uint32_t dispatches = 1, bool timed = false) {
+    TRACE_SCOPE("submit_dispatch");
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    WGPUComputePassDescriptor passDesc = {};
+    if (timed) passDesc.timestampWrites = gpuTimer.pass_writes();
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+
+    wgpuComputePassEncoderSetPipeline(pass, variant);
+    wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
+    for (uint32_t d = 0; d < dispatches; ++d) {
+        wgpuComputePassEncoderDispatchWorkgroups(pass, gridX, gridY, 1);
+    }
+
+    wgpuComputePassEncoderEnd(pass);
+    if (timed) gpuTimer.resolve(encoder);
+    WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+
+    {
+        TRACE_SCOPE("submit");
+        wgpuQueueSubmit(queue, 1, &commands);
+    }
+
+    wgpuCommandBufferRelease(commands);
+    wgpuComputePassEncoderRelease(pass);
+    wgpuCommandEncoderRelease(encoder);
+}
+
+// Timed-out GPU samples are dropped from the stats, so say how many there were
+void print_gpu_timeouts() {
+    if (gpuTimer.timeouts() > 0) {
+        std::cout << "[GPU timing] " << gpuTimer.timeouts() << " " << gpuTimer.source()
+                  << " sample(s) timed out and were dropped" << std::endl;
+    }
+}
+
+// GPU-bound repetitions can take hundreds of ms each, so cap them harder
+// than the harness default
+BenchConfig gpu_bench_config() {
+    BenchConfig cfg;
+    cfg.warmup = 2;
+    cfg.max_reps = 50;
+    cfg.max_time_ms = 4000;
+    return cfg;
+}
+
+// Per repetition: CPU encode + submit time is the primary sample, and the
+// pass's GPU duration (see GpuTimer) is recorded as "gpu".
 void run_test(const char* label, uint32_t gridX, uint32_t gridY) {
     uint32_t totalThreads = gridX * gridY * 64;
     uint32_t loops = std::max<uint32_t>(1, TOTAL_WORK_ITEMS / totalThreads);
@@ -135,58 +209,322 @@ void run_test(const char* label, uint32_t gridX, uint32_t gridY) {
     Uniforms u = { loops };
     wgpuQueueWriteBuffer(queue, uniformBuffer, 0, &u, sizeof(Uniforms));
 
-    double t0 = emscripten_get_now();
+    std::cout << "Test [" << label << "]:" << std::endl;
+    std::cout << "  Grid: (" << gridX << "x" << gridY << ") | Threads: " << totalThreads << std::endl;
+    std::cout << "  Loops/Thread: " << loops << std::endl;
 
-    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
-    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
+    std::string name = std::string("bloat/") + label;
+    BenchReport report = bench_run(name.c_str(), [&](BenchContext& ctx) {
+        double cpu = bench_time_ms([&] { submit_dispatch(pipeline, gridX, gridY, 1, true); });
+        GpuTiming gpu = gpuTimer.collect();
+        if (gpu.ok) ctx.record("gpu", gpu.ms);
+        return cpu;
+    }, gpu_bench_config());
+    bench_print(report);
+    if (report.metric("gpu").samples == 0) std::cout << "  GPU Execution Time: (every " << gpuTimer.source() << " sample timed out)" << std::endl;
+    print_divider();
+}
 
-    wgpuComputePassEncoderSetPipeline(pass, pipeline);
-    wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
-    wgpuComputePassEncoderDispatchWorkgroups(pass, gridX, gridY, 1);
+// --- Submission Strategies ---
+// Ways to issue many small (1,1,1) dispatches, from the baseline of one
+// encoder + pass + command buffer + submit per dispatch to batching K of them.
+// Each issues `total` dispatches in batches of up to `k`. WebGPU has no
+// reusable command buffers, so the closest thing to replaying a recording is
+// indirect dispatch from a pre-filled args buffer.
+const uint32_t MAX_BATCH = 64;
+const uint32_t BATCH_SIZES[] = { 8, 64 };
+
+void create_indirect_args() {
+    std::vector<uint32_t> args(MAX_BATCH * 3, 1u);
+    WGPUBufferDescriptor desc = {};
+    desc.size = args.size() * sizeof(uint32_t);
+    desc.usage = WGPUBufferUsage_Indirect | WGPUBufferUsage_CopyDst;
+    indirectArgsBuffer = wgpuDeviceCreateBuffer(device, &desc);
+    wgpuQueueWriteBuffer(queue, indirectArgsBuffer, 0, args.data(), desc.size);
+}
 
-    wgpuComputePassEncoderEnd(pass);
-    WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+void issue_per_dispatch(uint32_t total, uint32_t) {
+    for (uint32_t i = 0; i < total; ++i) submit_dispatch(pipeline, 1, 1);
+}
 
-    wgpuQueueSubmit(queue, 1, &commands);
+// K dispatches in one pass, one submit per batch
+void issue_dispatches_per_pass(uint32_t total, uint32_t k) {
+    for (uint32_t i = 0; i < total; i += k) submit_dispatch(pipeline, 1, 1, std::min(k, total - i));
+}
 
-    double t1 = emscripten_get_now();
+// K single-dispatch passes in one encoder, one submit per batch
+void issue_passes_per_encoder(uint32_t total, uint32_t k) {
+    for (uint32_t i = 0; i < total; i += k) {
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        for (uint32_t j = 0; j < std::min(k, total - i); ++j) {
+            WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
+            wgpuComputePassEncoderSetPipeline(pass, pipeline);
+            wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
+            wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
+            wgpuComputePassEncoderEnd(pass);
+            wgpuComputePassEncoderRelease(pass);
+        }
+        WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+        wgpuQueueSubmit(queue, 1, &commands);
+        wgpuCommandBufferRelease(commands);
+        wgpuCommandEncoderRelease(encoder);
+    }
+}
+
+// K single-dispatch command buffers handed to one wgpuQueueSubmit
+void issue_command_buffers_per_submit(uint32_t total, uint32_t k) {
+    WGPUCommandBuffer batch[MAX_BATCH];
+    for (uint32_t i = 0; i < total; i += k) {
+        uint32_t count = std::min(k, total - i);
+        for (uint32_t j = 0; j < count; ++j) {
+            WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+            WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
+            wgpuComputePassEncoderSetPipeline(pass, pipeline);
+            wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
+            wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
+            wgpuComputePassEncoderEnd(pass);
+            batch[j] = wgpuCommandEncoderFinish(encoder, nullptr);
+            wgpuComputePassEncoderRelease(pass);
+            wgpuCommandEncoderRelease(encoder);
+        }
+        wgpuQueueSubmit(queue, count, batch);
+        for (uint32_t j = 0; j < count; ++j) wgpuCommandBufferRelease(batch[j]);
+    }
+}
+
+// K indirect dispatches in one pass, reading (1,1,1) from indirectArgsBuffer
+void issue_indirect(uint32_t total, uint32_t k) {
+    for (uint32_t i = 0; i < total; i += k) {
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
+        wgpuComputePassEncoderSetPipeline(pass, pipeline);
+        wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
+        for (uint32_t j = 0; j < std::min(k, total - i); ++j) {
+            wgpuComputePassEncoderDispatchWorkgroupsIndirect(pass, indirectArgsBuffer, j * 3 * sizeof(uint32_t));
+        }
+        wgpuComputePassEncoderEnd(pass);
+        WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+        wgpuQueueSubmit(queue, 1, &commands);
+        wgpuCommandBufferRelease(commands);
+        wgpuComputePassEncoderRelease(pass);
+        wgpuCommandEncoderRelease(encoder);
+    }
+}
+
+struct BatchStrategy {
+    const char* name;
+    void (*issue)(uint32_t total, uint32_t k);
+};
 
-    // Try to measure GPU completion time using queue completion callback
-    struct QueueDone { double submitTime; double endTime; bool done; } qd;
-    qd.submitTime = t1; qd.endTime = 0.0; qd.done = false;
-    auto queueDoneCb = [](WGPUQueueWorkDoneStatus status, void* userdata) {
-        QueueDone* d = (QueueDone*)userdata;
-        d->endTime = emscripten_get_now();
-        d->done = true;
-    };
+const BatchStrategy BATCH_STRATEGIES[] = {
+    { "dispatches-per-pass", issue_dispatches_per_pass },
+    { "passes-per-encoder", issue_passes_per_encoder },
+    { "cmdbufs-per-submit", issue_command_buffers_per_submit },
+    { "indirect-per-pass", issue_indirect },
+};
 
-    // Register callback
-    wgpuQueueOnSubmittedWorkDone(queue, [](WGPUQueueWorkDoneStatus status, void* userdata){ QueueDone* d = (QueueDone*)userdata; d->endTime = emscripten_get_now(); d->done = true; }, &qd);
+// Times `total` dispatches issued through `issue`: CPU issue time is the
+// primary sample, the GPU span from first to last submit is recorded as "gpu"
+BenchReport bench_issue(const std::string& name, void (*issue)(uint32_t, uint32_t), uint32_t total, uint32_t k) {
+    BenchConfig cfg = gpu_bench_config();
+    cfg.ops_per_rep = total; // Dispatches per second
+    return bench_run(name.c_str(), [&](BenchContext& ctx) {
+        gpuTimer.submit_begin();
+        double cpu = bench_time_ms([&] {
+            TRACE_SCOPE("issue");
+            issue(total, k);
+        });
+        gpuTimer.submit_end();
+        GpuTiming gpu = gpuTimer.collect();
+        if (gpu.ok) ctx.record("gpu", gpu.ms);
+        return cpu;
+    }, cfg);
+}
 
-    // Wait for GPU completion with timeout
-    int waitTicks = 0;
-    while (!qd.done && waitTicks < 200) {
-        emscripten_sleep(10);
-        waitTicks++;
+// Runs every strategy at each batch size and reports it against `baseline`
+void run_batching_strategies(const BenchReport& baseline, uint32_t total) {
+    std::cout << "Batching strategies (" << total << " dispatches of 1,1,1, vs one submit per dispatch)" << std::endl;
+    for (uint32_t k : BATCH_SIZES) {
+        for (const BatchStrategy& strategy : BATCH_STRATEGIES) {
+            std::string name = std::string("bloat/batching/") + strategy.name + "/k=" + std::to_string(k);
+            BenchReport report = bench_issue(name, strategy.issue, total, k);
+            bench_print(report);
+            double speedup = report.stats.median > 0.0 ? baseline.stats.median / report.stats.median : 0.0;
+            std::cout << "  CPU " << report.stats.median * 1000.0 / total << " us/dispatch, "
+                      << speedup << "x vs baseline" << std::endl;
+            std::cout << "RESULT: {\"name\":\"" << name << "/speedup\",\"baseline\":\"" << baseline.name
+                      << "\",\"speedup\":" << speedup << "}" << std::endl;
+        }
     }
+}
 
-    double gpuTime = qd.done ? (qd.endTime - qd.submitTime) : -1.0;
+// --- Allocation Probes ---
+// Heap allocations per dispatch of the baseline and per batch of each
+// strategy (common/alloc_tracker.h). Natively these are the stand-in device's
+// objects; in the browser the WebGPU objects live on the JS side, so only
+// the C++-side bookkeeping is counted.
+void run_alloc_probes() {
+    alloc_probe("bloat/alloc/per-dispatch", 1000, "dispatch", [] { issue_per_dispatch(1, 1); });
+    const uint32_t k = MAX_BATCH;
+    for (const BatchStrategy& strategy : BATCH_STRATEGIES) {
+        std::string name = std::string("bloat/alloc/") + strategy.name + "/k=" + std::to_string(k);
+        alloc_probe(name.c_str(), 100, "batch", [&] { strategy.issue(k, k); });
+    }
+    emscripten_sleep(0); // Lets the queued completions run before the next mode
+}
 
-    // Cleanup
-    wgpuCommandBufferRelease(commands);
-    wgpuComputePassEncoderRelease(pass);
-    wgpuCommandEncoderRelease(encoder);
+// --- Sweep Mode ---
+// Walks workgroup size x workgroup count (log-spaced) x dispatches per submit.
+// Every submit does the same total work (SWEEP_WORK_ITEMS loop iterations,
+// split across threads and dispatches), so the surface shows where the CPU
+// encode + submit cost stops dominating GPU execution. The workgroup count
+// stops at one iteration per thread, where the budget runs out; all counts
+// are powers of two, so the split is exact.
+const uint32_t SWEEP_WORK_ITEMS = 1u << 24;
+const uint32_t SWEEP_WORKGROUP_SIZES[] = { 32, 64, 128, 256 };
+const uint32_t SWEEP_DISPATCHES_PER_SUBMIT[] = { 1, 8, 64 };
+const uint32_t SWEEP_MAX_WORKGROUPS = 1u << 16;
+const uint32_t MAX_GRID_DIMENSION = 65535;
+
+struct SweepPoint {
+    uint32_t workgroupSize;
+    uint32_t workgroups;
+    uint32_t dispatchesPerSubmit;
+    uint32_t gridX, gridY;
+    uint32_t loops;
+    BenchStats cpu;  // Encode + submit
+    BenchStats gpu;  // GpuTimer: timestamp-query span, or the work-done callback round trip
+    bool converged;
+};
 
-    std::cout << "Test [" << label << "]:" << std::endl;
-    std::cout << "  Grid: (" << gridX << "x" << gridY << ") | Threads: " << totalThreads << std::endl;
-    std::cout << "  Loops/Thread: " << loops << std::endl;
-    std::cout << "  CPU Dispatch Overhead: " << (t1 - t0) << " ms" << std::endl;
-    if (gpuTime >= 0.0) std::cout << "  Approx GPU Execution Time: " << gpuTime << " ms" << std::endl; else std::cout << "  GPU Execution Time: (timeout or unsupported)" << std::endl;
-    print_divider();
+// Work items per second (millions) from the GPU completion median
+double sweep_throughput(const SweepPoint& p) {
+    double items = (double)p.workgroups * p.workgroupSize * p.loops * p.dispatchesPerSubmit;
+    return p.gpu.median > 0.0 ? items / (p.gpu.median * 1000.0) : 0.0;
+}
+
+std::vector<SweepPoint> run_sweep() {
+    BenchConfig cfg;
+    cfg.warmup = 1;
+    cfg.min_reps = 3;
+    cfg.max_reps = 20;
+    cfg.target_rme = 0.05;
+    cfg.max_time_ms = 500;
+
+    std::vector<SweepPoint> points;
+    for (uint32_t wgSize : SWEEP_WORKGROUP_SIZES) {
+        WGPUComputePipeline variant = create_pipeline(wgSize);
+        if (!variant) {
+            std::cout << "[sweep] Failed to compile @workgroup_size(" << wgSize << "), skipping." << std::endl;
+            continue;
+        }
+        for (uint32_t dispatches : SWEEP_DISPATCHES_PER_SUBMIT) {
+            const uint32_t maxGroups = std::min(SWEEP_MAX_WORKGROUPS, SWEEP_WORK_ITEMS / (wgSize * dispatches));
+            for (uint32_t groups = 1; groups <= maxGroups; groups *= 4) {
+                SweepPoint p = {};
+                p.workgroupSize = wgSize;
+                p.workgroups = groups;
+                p.dispatchesPerSubmit = dispatches;
+                // Counts are powers of two, so halving keeps gridX * gridY exact
+                p.gridX = groups;
+                while (p.gridX > MAX_GRID_DIMENSION) p.gridX /= 2;
+                p.gridY = groups / p.gridX;
+                p.loops = SWEEP_WORK_ITEMS / (groups * wgSize * dispatches);
+
+                Uniforms u = { p.loops };
+                wgpuQueueWriteBuffer(queue, uniformBuffer, 0, &u, sizeof(Uniforms));
+
+                BenchReport report = bench_run("bloat/sweep", [&](BenchContext& ctx) {
+                    double cpu = bench_time_ms([&] { submit_dispatch(variant, p.gridX, p.gridY, dispatches, true); });
+                    GpuTiming gpu = gpuTimer.collect();
+                    if (gpu.ok) ctx.record("gpu", gpu.ms);
+                    return cpu;
+                }, cfg);
+                p.cpu = report.stats;
+                p.gpu = report.metric("gpu");
+                p.converged = report.converged;
+                points.push_back(p);
+            }
+        }
+        wgpuComputePipelineRelease(variant);
+    }
+    return points;
+}
+
+void write_sweep_csv(std::ostream& out, const std::vector<SweepPoint>& points) {
+    out << "workgroup_size,workgroups,dispatches_per_submit,grid_x,grid_y,loops_per_thread,"
+           "cpu_median_ms,cpu_p95_ms,cpu_us_per_dispatch,gpu_median_ms,gpu_p95_ms,gpu_mitems_per_s,samples,converged\n";
+    for (const SweepPoint& p : points) {
+        out << p.workgroupSize << ',' << p.workgroups << ',' << p.dispatchesPerSubmit << ','
+            << p.gridX << ',' << p.gridY << ',' << p.loops << ','
+            << p.cpu.median << ',' << p.cpu.p95 << ',' << p.cpu.median * 1000.0 / p.dispatchesPerSubmit << ','
+            << p.gpu.median << ',' << p.gpu.p95 << ',' << sweep_throughput(p) << ','
+            << p.cpu.samples << ',' << (p.converged ? 1 : 0) << '\n';
+    }
+}
+
+void write_sweep_json(std::ostream& out, const std::vector<SweepPoint>& points) {
+    out << "{\"name\":\"bloat/sweep\",\"workItemsPerSubmit\":" << SWEEP_WORK_ITEMS << ",\"points\":[";
+    for (size_t i = 0; i < points.size(); ++i) {
+        const SweepPoint& p = points[i];
+        out << (i ? "," : "")
+            << "{\"workgroupSize\":" << p.workgroupSize << ",\"workgroups\":" << p.workgroups
+            << ",\"dispatchesPerSubmit\":" << p.dispatchesPerSubmit << ",\"loopsPerThread\":" << p.loops
+            << ",\"cpuMedianMs\":" << p.cpu.median << ",\"cpuP95Ms\":" << p.cpu.p95
+            << ",\"gpuMedianMs\":" << p.gpu.median << ",\"gpuP95Ms\":" << p.gpu.p95
+            << ",\"gpuMItemsPerSec\":" << sweep_throughput(p) << ",\"samples\":" << p.cpu.samples
+            << ",\"converged\":" << (p.converged ? "true" : "false") << "}";
+    }
+    out << "]}";
+}
+
+// Prints, per (workgroup size, dispatches per submit), the first workgroup
+// count where GPU time exceeds the CPU encode + submit time
+void print_sweep_summary(const std::vector<SweepPoint>& points) {
+    std::cout << "Sweep: first workgroup count where GPU time > CPU submit time" << std::endl;
+    for (uint32_t wgSize : SWEEP_WORKGROUP_SIZES) {
+        for (uint32_t dispatches : SWEEP_DISPATCHES_PER_SUBMIT) {
+            const SweepPoint* crossover = nullptr;
+            for (const SweepPoint& p : points) {
+                if (p.workgroupSize == wgSize && p.dispatchesPerSubmit == dispatches && p.gpu.median > p.cpu.median) {
+                    crossover = &p;
+                    break;
+                }
+            }
+            std::cout << "  @workgroup_size(" << wgSize << "), " << dispatches << " dispatch(es)/submit: ";
+            if (crossover) std::cout << crossover->workgroups << " workgroups" << std::endl;
+            else std::cout << "CPU-bound across the sweep" << std::endl;
+        }
+    }
 }
 
-int main() {
+// Usage: bloat_test [--sweep] [--csv FILE] [--json FILE] [--alloc] [--trace FILE]
+// Without --sweep the fixed scenarios run; --alloc runs only the allocation
+// probes. The sweep prints the surface as
+// CSV unless --csv / --json name output files. --trace writes a Chrome trace
+// (common/trace.h) on exit.
+int main(int argc, char** argv) {
+    bool sweep = false;
+    bool alloc = false;
+    const char* csvPath = nullptr;
+    const char* jsonPath = nullptr;
+    const char* tracePath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sweep") sweep = true;
+        else if (arg == "--alloc") alloc = true;
+        else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) jsonPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else {
+            std::cout << "usage: bloat_test [--sweep] [--csv FILE] [--json FILE] [--alloc] [--trace FILE]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
     std::cout << "--- BENCHMARK 1: COMMAND BUFFER BLOAT ---" << std::endl;
+    // Chrome trace of every thread, written when main returns
+    TraceSession trace(tracePath);
 
     // Request adapter/device
     WGPUInstanceDescriptor desc = {};
@@ -204,11 +542,42 @@ int main() {
         std::cout << "Failed to obtain GPU device. Exiting." << std::endl;
         return 1;
     }
+    wgpuInstanceRelease(instance);
 
     if (!createShaderAndPipeline()) {
         std::cout << "Failed to create pipeline." << std::endl;
         return 1;
     }
+    create_indirect_args();
+    gpuTimer.init(device, queue);
+    std::cout << "[setup] GPU timing: " << gpuTimer.source() << std::endl;
+
+    if (alloc) {
+        run_alloc_probes();
+        return 0;
+    }
+
+    if (sweep) {
+        std::vector<SweepPoint> points = run_sweep();
+        if (csvPath) {
+            std::ofstream csv(csvPath);
+            write_sweep_csv(csv, points);
+            std::cout << "[sweep] Wrote " << points.size() << " points to " << csvPath << std::endl;
+        }
+        if (jsonPath) {
+            std::ofstream json(jsonPath);
+            write_sweep_json(json, points);
+            std::cout << "[sweep] Wrote " << points.size() << " points to " << jsonPath << std::endl;
+        }
+        if (!csvPath && !jsonPath) write_sweep_csv(std::cout, points);
+        // One line the UI can pick up without file access
+        std::cout << "RESULT: ";
+        write_sweep_json(std::cout, points);
+        std::cout << std::endl;
+        print_sweep_summary(points);
+        print_gpu_timeouts();
+        return 0;
+    }
 
     // SCENARIO 1: Minimal Dispatch (1 Group)
     run_test("Minimal (1 group)", 1, 1);
@@ -220,34 +589,20 @@ int main() {
     run_test("Bloated (large grid)", 2048, 2048);
 
     // REFINE: Repeated small dispatches (dispatch called many times)
-    std::cout << "Refinement: Repeated small dispatches (10000 dispatches of 1,1,1)" << std::endl;
-    double t0 = emscripten_get_now();
-    for (int i = 0; i < 10000; ++i) {
-        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
-        WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, nullptr);
-        wgpuComputePassEncoderSetPipeline(pass, pipeline);
-        wgpuComputePassEncoderSetBindGroup(pass, 0, bindGroup, 0, nullptr);
-        wgpuComputePassEncoderDispatchWorkgroups(pass, 1, 1, 1);
-        wgpuComputePassEncoderEnd(pass);
-        WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
-        wgpuQueueSubmit(queue, 1, &commands);
-        wgpuCommandBufferRelease(commands);
-        wgpuComputePassEncoderRelease(pass);
-        wgpuCommandEncoderRelease(encoder);
-    }
-    double t1 = emscripten_get_now();
-    std::cout << "  Repeated dispatch submission overhead: " << (t1 - t0) << " ms for 10000 dispatches" << std::endl;
-
-    // Measure when GPU actually finishes those submissions
-    struct QueueDoneR { double submitTime; double endTime; bool done; } qdr{ t1, 0.0, false };
-    wgpuQueueOnSubmittedWorkDone(queue, [](WGPUQueueWorkDoneStatus status, void* userdata){ QueueDoneR* d = (QueueDoneR*)userdata; d->endTime = emscripten_get_now(); d->done = true; }, &qdr);
+    const uint32_t kRepeatedDispatches = 10000;
+    std::cout << "Refinement: Repeated small dispatches (" << kRepeatedDispatches << " dispatches of 1,1,1)" << std::endl;
+    // GPU completion of those submissions is recorded as ".../gpu"
+    BenchReport repeated = bench_issue("bloat/Repeated small dispatches", issue_per_dispatch, kRepeatedDispatches, 1);
+    bench_print(repeated);
+    if (repeated.metric("gpu").samples == 0) std::cout << "  Repeated dispatch GPU time: (every " << gpuTimer.source() << " sample timed out)" << std::endl;
+    print_divider();
 
-    int wait2 = 0;
-    while (!qdr.done && wait2 < 1000) { emscripten_sleep(5); wait2++; }
-    if (qdr.done) std::cout << "  Repeated dispatch GPU completion: " << (qdr.endTime - qdr.submitTime) << " ms" << std::endl; else std::cout << "  Repeated dispatch GPU completion: (timeout or unsupported)" << std::endl;
+    // Same dispatches, batched
+    run_batching_strategies(repeated, kRepeatedDispatches);
 
     print_divider();
 
+    print_gpu_timeouts();
     std::cout << "Benchmark complete." << std::endl;
     return 0;
 }
@@ -11,6 +11,9 @@ emcc upload_benchmark.cpp -o "$OUT_DIR/upload_benchmark.html" \
   -pthread \
   -s PROXY_TO_PTHREAD \
   -s PTHREAD_POOL_SIZE=8 \
+  -s ALLOW_MEMORY_GROWTH=1 \
+  -msimd128 \
+  -ffp-contract=off \
   -std=c++17 \
   -O3
 
@@ -0,0 +1,284 @@
+#pragma once
+// Producer kernels for upload_benchmark: out[i] = sin(x) * cos(x) + sqrt(x)
+// with x = i * 0.0001 + seed, at three precision tiers.
+//
+//   Exact — libm sinf / cosf, one element at a time (the original kernel).
+//   High  — shared Cody-Waite reduction to [-pi/4, pi/4] plus degree 7 / 8
+//           minimax polynomials (Cephes sinf / cosf). Max error 2 ULP for sin
+//           and cos over the benchmark's input range (0 <= x <= 2000), measured
+//           against double-precision libm.
+//   Fast  — same reduction, degree 5 / 4 Taylor polynomials. Absolute error
+//           stays below 4e-4, which is up to ~5500 ULP near the zeros of sin/cos.
+//
+// The polynomial tiers run PRODUCER_SIMD_WIDTH lanes per iteration. The scalar
+// fallback (used for tails and non-SIMD builds) performs the same operations in
+// the same order, so both give bit-identical output as long as the compiler
+// does not contract a * b + c into an FMA. Build with -ffp-contract=off (CMake
+// and build.sh do); with -march=native and contraction on, tens of thousands of
+// the 4M outputs differ in the last bits. The ULP bounds above hold either
+// way. producer_measure_ulp() reports the measured error at startup.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Pick the widest SIMD instruction set the compiler was told to target. The
+// quadrant logic needs 32-bit integer lanes, so 256-bit needs AVX2.
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define PRODUCER_SIMD_WIDTH 4
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define PRODUCER_SIMD_WIDTH 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define PRODUCER_SIMD_WIDTH 4
+#else
+#define PRODUCER_SIMD_WIDTH 0
+#endif
+
+enum class ProducerPrecision { Exact, High, Fast };
+
+const ProducerPrecision PRODUCER_PRECISIONS[] = { ProducerPrecision::Exact, ProducerPrecision::High, ProducerPrecision::Fast };
+
+inline const char* producer_precision_name(ProducerPrecision p) {
+    switch (p) {
+        case ProducerPrecision::Exact: return "exact";
+        case ProducerPrecision::High: return "high";
+        case ProducerPrecision::Fast: return "fast";
+    }
+    return "?";
+}
+
+inline bool parse_producer_precision(const char* name, ProducerPrecision& out) {
+    for (ProducerPrecision p : PRODUCER_PRECISIONS) {
+        if (std::strcmp(name, producer_precision_name(p)) == 0) {
+            out = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- Polynomial Constants ---
+// pi/2 split into four parts (SLEEF's PI_A..PI_D halved); the first three have
+// few enough mantissa bits that k * part is exact for the quadrant counts
+// reached here, so the reduction keeps its accuracy near multiples of pi/2.
+const float PK_2_OVER_PI = 0.636619772367581343f;
+const float PK_PIO2_1 = 1.5703125f;
+const float PK_PIO2_2 = 4.83512878417968750e-4f;
+const float PK_PIO2_3 = 3.13855707645416259766e-7f;
+const float PK_PIO2_4 = 6.07710050650619224932e-11f;
+
+// Cephes sinf / cosf minimax coefficients on [-pi/4, pi/4]
+const float PK_SIN_1 = -1.6666654611e-1f;
+const float PK_SIN_2 = 8.3321608736e-3f;
+const float PK_SIN_3 = -1.9515295891e-4f;
+const float PK_COS_1 = 4.166664568298827e-2f;
+const float PK_COS_2 = -1.388731625493765e-3f;
+const float PK_COS_3 = 2.443315711809948e-5f;
+
+// Taylor coefficients for the fast tier
+const float PK_FAST_SIN_1 = -1.0f / 6.0f;
+const float PK_FAST_SIN_2 = 1.0f / 120.0f;
+const float PK_FAST_COS_1 = -0.5f;
+const float PK_FAST_COS_2 = 1.0f / 24.0f;
+
+// --- Scalar Reference ---
+// Same operation order as the SIMD kernel
+inline void producer_sincos(float x, ProducerPrecision p, float& s, float& c) {
+    if (p == ProducerPrecision::Exact) {
+        s = std::sin(x);
+        c = std::cos(x);
+        return;
+    }
+    int32_t q = (int32_t)std::nearbyint(x * PK_2_OVER_PI);
+    float k = (float)q;
+    float r = (((x - k * PK_PIO2_1) - k * PK_PIO2_2) - k * PK_PIO2_3) - k * PK_PIO2_4;
+    float r2 = r * r;
+
+    float ps, pc;
+    if (p == ProducerPrecision::High) {
+        ps = r + r * r2 * (PK_SIN_1 + r2 * (PK_SIN_2 + r2 * PK_SIN_3));
+        pc = (1.0f - 0.5f * r2) + r2 * r2 * (PK_COS_1 + r2 * (PK_COS_2 + r2 * PK_COS_3));
+    } else {
+        ps = r + r * r2 * (PK_FAST_SIN_1 + r2 * PK_FAST_SIN_2);
+        pc = 1.0f + r2 * (PK_FAST_COS_1 + r2 * PK_FAST_COS_2);
+    }
+
+    // Odd quadrants swap sin and cos; quadrants 2-3 negate sin, 1-2 negate cos
+    s = (q & 1) ? pc : ps;
+    c = (q & 1) ? ps : pc;
+    if (q & 2) s = -s;
+    if ((q + 1) & 2) c = -c;
+}
+
+inline float producer_value(float x, ProducerPrecision p) {
+    float s, c;
+    producer_sincos(x, p, s, c);
+    return s * c + std::sqrt(x);
+}
+
+#if PRODUCER_SIMD_WIDTH > 0
+// --- SIMD Primitives ---
+#if defined(__wasm_simd128__)
+typedef v128_t pk_f;
+typedef v128_t pk_i;
+inline void pk_store(float* p, pk_f v) { wasm_v128_store(p, v); }
+inline pk_f pk_set1(float v) { return wasm_f32x4_splat(v); }
+inline pk_i pk_set1_i(int32_t v) { return wasm_i32x4_splat(v); }
+inline pk_i pk_iota_i() { return wasm_i32x4_make(0, 1, 2, 3); }
+inline pk_f pk_add(pk_f a, pk_f b) { return wasm_f32x4_add(a, b); }
+inline pk_f pk_sub(pk_f a, pk_f b) { return wasm_f32x4_sub(a, b); }
+inline pk_f pk_mul(pk_f a, pk_f b) { return wasm_f32x4_mul(a, b); }
+inline pk_f pk_sqrt(pk_f a) { return wasm_f32x4_sqrt(a); }
+inline pk_f pk_xor(pk_f a, pk_f b) { return wasm_v128_xor(a, b); }
+inline pk_f pk_select(pk_f mask, pk_f a, pk_f b) { return wasm_v128_bitselect(a, b, mask); }
+inline pk_i pk_round_i(pk_f a) { return wasm_i32x4_trunc_sat_f32x4(wasm_f32x4_nearest(a)); }
+inline pk_f pk_to_f(pk_i a) { return wasm_f32x4_convert_i32x4(a); }
+inline pk_i pk_add_i(pk_i a, pk_i b) { return wasm_i32x4_add(a, b); }
+inline pk_i pk_and_i(pk_i a, pk_i b) { return wasm_v128_and(a, b); }
+inline pk_i pk_eq_i(pk_i a, pk_i b) { return wasm_i32x4_eq(a, b); }
+inline pk_f pk_sign_from_bit1(pk_i a) { return wasm_i32x4_shl(a, 30); } // Bit 1 -> sign bit
+inline pk_f pk_as_f(pk_i a) { return a; }
+#elif defined(__AVX2__)
+typedef __m256 pk_f;
+typedef __m256i pk_i;
+inline void pk_store(float* p, pk_f v) { _mm256_storeu_ps(p, v); }
+inline pk_f pk_set1(float v) { return _mm256_set1_ps(v); }
+inline pk_i pk_set1_i(int32_t v) { return _mm256_set1_epi32(v); }
+inline pk_i pk_iota_i() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+inline pk_f pk_add(pk_f a, pk_f b) { return _mm256_add_ps(a, b); }
+inline pk_f pk_sub(pk_f a, pk_f b) { return _mm256_sub_ps(a, b); }
+inline pk_f pk_mul(pk_f a, pk_f b) { return _mm256_mul_ps(a, b); }
+inline pk_f pk_sqrt(pk_f a) { return _mm256_sqrt_ps(a); }
+inline pk_f pk_xor(pk_f a, pk_f b) { return _mm256_xor_ps(a, b); }
+inline pk_f pk_select(pk_f mask, pk_f a, pk_f b) { return _mm256_blendv_ps(b, a, mask); }
+inline pk_i pk_round_i(pk_f a) { return _mm256_cvtps_epi32(a); }
+inline pk_f pk_to_f(pk_i a) { return _mm256_cvtepi32_ps(a); }
+inline pk_i pk_add_i(pk_i a, pk_i b) { return _mm256_add_epi32(a, b); }
+inline pk_i pk_and_i(pk_i a, pk_i b) { return _mm256_and_si256(a, b); }
+inline pk_i pk_eq_i(pk_i a, pk_i b) { return _mm256_cmpeq_epi32(a, b); }
+inline pk_f pk_sign_from_bit1(pk_i a) { return _mm256_castsi256_ps(_mm256_slli_epi32(a, 30)); }
+inline pk_f pk_as_f(pk_i a) { return _mm256_castsi256_ps(a); }
+#else // SSE2
+typedef __m128 pk_f;
+typedef __m128i pk_i;
+inline void pk_store(float* p, pk_f v) { _mm_storeu_ps(p, v); }
+inline pk_f pk_set1(float v) { return _mm_set1_ps(v); }
+inline pk_i pk_set1_i(int32_t v) { return _mm_set1_epi32(v); }
+inline pk_i pk_iota_i() { return _mm_setr_epi32(0, 1, 2, 3); }
+inline pk_f pk_add(pk_f a, pk_f b) { return _mm_add_ps(a, b); }
+inline pk_f pk_sub(pk_f a, pk_f b) { return _mm_sub_ps(a, b); }
+inline pk_f pk_mul(pk_f a, pk_f b) { return _mm_mul_ps(a, b); }
+inline pk_f pk_sqrt(pk_f a) { return _mm_sqrt_ps(a); }
+inline pk_f pk_xor(pk_f a, pk_f b) { return _mm_xor_ps(a, b); }
+inline pk_f pk_select(pk_f mask, pk_f a, pk_f b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+inline pk_i pk_round_i(pk_f a) { return _mm_cvtps_epi32(a); }
+inline pk_f pk_to_f(pk_i a) { return _mm_cvtepi32_ps(a); }
+inline pk_i pk_add_i(pk_i a, pk_i b) { return _mm_add_epi32(a, b); }
+inline pk_i pk_and_i(pk_i a, pk_i b) { return _mm_and_si128(a, b); }
+inline pk_i pk_eq_i(pk_i a, pk_i b) { return _mm_cmpeq_epi32(a, b); }
+inline pk_f pk_sign_from_bit1(pk_i a) { return _mm_castsi128_ps(_mm_slli_epi32(a, 30)); }
+inline pk_f pk_as_f(pk_i a) { return _mm_castsi128_ps(a); }
+#endif
+
+// PRODUCER_SIMD_WIDTH elements per iteration; returns the first index not written
+template <ProducerPrecision P>
+size_t produce_range_simd(float* out, size_t begin, size_t end, int seed) {
+    const pk_f v_step = pk_set1(0.0001f);
+    const pk_f v_seed = pk_set1((float)seed);
+    const pk_f v_2_over_pi = pk_set1(PK_2_OVER_PI);
+    const pk_f v_pio2_1 = pk_set1(PK_PIO2_1);
+    const pk_f v_pio2_2 = pk_set1(PK_PIO2_2);
+    const pk_f v_pio2_3 = pk_set1(PK_PIO2_3);
+    const pk_f v_pio2_4 = pk_set1(PK_PIO2_4);
+    const pk_f v_one = pk_set1(1.0f);
+    const pk_f v_half = pk_set1(0.5f);
+    const pk_i v_i1 = pk_set1_i(1);
+    const pk_i v_i2 = pk_set1_i(2);
+    const pk_i v_lane = pk_iota_i();
+
+    size_t i = begin;
+    for (; i + PRODUCER_SIMD_WIDTH <= end; i += PRODUCER_SIMD_WIDTH) {
+        // float(i) per lane (exact: DATA_SIZE < 2^24), then x as in the scalar code
+        pk_f fi = pk_to_f(pk_add_i(pk_set1_i((int32_t)i), v_lane));
+        pk_f x = pk_add(pk_mul(fi, v_step), v_seed);
+
+        pk_i q = pk_round_i(pk_mul(x, v_2_over_pi));
+        pk_f k = pk_to_f(q);
+        pk_f r = pk_sub(pk_sub(pk_sub(pk_sub(x, pk_mul(k, v_pio2_1)), pk_mul(k, v_pio2_2)), pk_mul(k, v_pio2_3)),
+                        pk_mul(k, v_pio2_4));
+        pk_f r2 = pk_mul(r, r);
+
+        pk_f ps, pc;
+        if (P == ProducerPrecision::High) {
+            ps = pk_add(r, pk_mul(pk_mul(r, r2),
+                     pk_add(pk_set1(PK_SIN_1), pk_mul(r2, pk_add(pk_set1(PK_SIN_2), pk_mul(r2, pk_set1(PK_SIN_3)))))));
+            pc = pk_add(pk_sub(v_one, pk_mul(v_half, r2)), pk_mul(pk_mul(r2, r2),
+                     pk_add(pk_set1(PK_COS_1), pk_mul(r2, pk_add(pk_set1(PK_COS_2), pk_mul(r2, pk_set1(PK_COS_3)))))));
+        } else {
+            ps = pk_add(r, pk_mul(pk_mul(r, r2), pk_add(pk_set1(PK_FAST_SIN_1), pk_mul(r2, pk_set1(PK_FAST_SIN_2)))));
+            pc = pk_add(v_one, pk_mul(r2, pk_add(pk_set1(PK_FAST_COS_1), pk_mul(r2, pk_set1(PK_FAST_COS_2)))));
+        }
+
+        pk_f swap = pk_as_f(pk_eq_i(pk_and_i(q, v_i1), v_i1));
+        pk_f s = pk_xor(pk_select(swap, pc, ps), pk_sign_from_bit1(pk_and_i(q, v_i2)));
+        pk_f c = pk_xor(pk_select(swap, ps, pc), pk_sign_from_bit1(pk_and_i(pk_add_i(q, v_i1), v_i2)));
+        pk_store(out + i, pk_add(pk_mul(s, c), pk_sqrt(x)));
+    }
+    return i;
+}
+#endif
+
+// Fills out[begin, end) for the given tier
+inline void produce_range(float* out, size_t begin, size_t end, int seed, ProducerPrecision p) {
+    size_t i = begin;
+#if PRODUCER_SIMD_WIDTH > 0
+    if (p == ProducerPrecision::High) i = produce_range_simd<ProducerPrecision::High>(out, begin, end, seed);
+    else if (p == ProducerPrecision::Fast) i = produce_range_simd<ProducerPrecision::Fast>(out, begin, end, seed);
+#endif
+    for (; i < end; ++i) {
+        float x = float(i) * 0.0001f + seed;
+        out[i] = producer_value(x, p);
+    }
+}
+
+// --- Accuracy ---
+// Distance in representable floats between a and b
+inline uint32_t producer_ulp_distance(float a, float b) {
+    int32_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(ia));
+    std::memcpy(&ib, &b, sizeof(ib));
+    // Map sign-magnitude to a monotonic integer line
+    if (ia < 0) ia = INT32_MIN - ia;
+    if (ib < 0) ib = INT32_MIN - ib;
+    int64_t d = (int64_t)ia - (int64_t)ib;
+    return (uint32_t)(d < 0 ? -d : d);
+}
+
+struct ProducerUlp {
+    uint32_t sin_max = 0;
+    uint32_t cos_max = 0;
+    double abs_max = 0;     // Largest absolute error of sin or cos
+};
+
+// Max error of a tier's sin / cos against double-precision libm, over
+// `samples` evenly spaced points in [lo, hi]
+inline ProducerUlp producer_measure_ulp(ProducerPrecision p, float lo, float hi, int samples) {
+    ProducerUlp u;
+    for (int n = 0; n < samples; n++) {
+        float x = lo + (hi - lo) * (float)n / (float)(samples - 1);
+        float s, c;
+        producer_sincos(x, p, s, c);
+        double rs = std::sin((double)x), rc = std::cos((double)x);
+        uint32_t es = producer_ulp_distance(s, (float)rs);
+        uint32_t ec = producer_ulp_distance(c, (float)rc);
+        if (es > u.sin_max) u.sin_max = es;
+        if (ec > u.cos_max) u.cos_max = ec;
+        double ea = std::fmax(std::fabs(s - rs), std::fabs(c - rc));
+        if (ea > u.abs_max) u.abs_max = ea;
+    }
+    return u;
+}
@@ -1,35 +1,62 @@
+#include <algorithm>
 #include <iostream>
+#include <iterator>
 #include <vector>
+#include <string>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <atomic>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <emscripten/emscripten.h>
 #include <webgpu/webgpu.h>
 
+#include "../common/alloc_tracker.h"
+#include "../common/bench_harness.h"
+#include "../common/dirty_ranges.h"
+#include "../common/frame_arena.h"
+#include "../common/gpu_timer.h"
+#include "../common/locked_ring.h"
+#include "../common/spsc_ring.h"
+#include "../common/staging_belt.h"
+#include "../common/sync_stats.h"
+#include "../common/thread_pool.h"
+#include "../common/trace.h"
+#include "producer_kernels.h"
+
 // --- Configuration ---
 const size_t DATA_SIZE = 1024 * 1024 * 4; // 4M floats (~16MB)
 const int NUM_FRAMES = 10;
+// Ring depths swept by the pipelined modes (each slot is a DATA_SIZE buffer)
+const size_t PIPELINE_DEPTHS[] = {1, 2, 4, 8};
+// Delta-upload sweep (--delta): fraction of 4 KiB pages dirtied per frame, and
+// the longest run of clean pages merged into a surrounding upload
+const double DELTA_DIRTY_FRACTIONS[] = {0.01, 0.05, 0.10, 0.25, 0.50, 0.75, 1.00};
+const uint64_t DELTA_MAX_GAP_PAGES[] = {0, 4, 32};
 
 // --- State ---
 WGPUDevice device = nullptr;
 WGPUQueue queue = nullptr;
 WGPUBuffer gpuBuffer = nullptr; // A single massive storage buffer on GPU
+GpuTimer gpuTimer;              // Times the staging copy; used by one thread at a time
 
-// Two CPU buffers for "Ping-Pong" (allocate as vectors so we can pass .data())
+// CPU buffer for the serial modes (a vector so we can pass .data())
 static std::vector<float> cpuBufferA;
-static std::vector<float> cpuBufferB;
 
-// Sync Primitives
-std::mutex mtx;
-std::condition_variable cv_upload; // Signals GPU thread to work
-std::condition_variable cv_compute; // Signals Compute thread to work
+// Frames in flight between the producer (main thread) and the uploader
+// thread in the pipelined modes; depth is set per run. LockedRing is the
+// mutex + condvar handoff, kept as the baseline for --sync.
+typedef SpscRing<std::vector<float>> UploadRing;
+typedef LockedRing<std::vector<float>> LockedUploadRing;
+
+// Producer kernel tier (--precision) and whether it runs on the pool or the
+// calling thread; the crossover benchmark switches both
+ProducerPrecision producer_precision = ProducerPrecision::High;
+bool producer_parallel = true;
 
-// State Flags
-std::atomic<bool> bufferA_ready_for_upload(false);
-std::atomic<bool> bufferB_ready_for_upload(false);
-std::atomic<bool> done(false);
+// writeBuffer / map+copy times of the last pipelined run; only the uploader
+// thread appends, main reads after join()
+std::vector<double> uploader_samples;
 
 // --- WebGPU Helper (Simplified) ---
 void onDeviceRequestEnded(WGPURequestDeviceStatus status, WGPUDevice inDevice, const char* message, void* userdata) {
@@ -45,258 +72,814 @@ void onDeviceRequestEnded(WGPURequestDeviceStatus status, WGPUDevice inDevice, c
 void onAdapterRequestEnded(WGPURequestAdapterStatus status, WGPUAdapter adapter, const char* message, void* userdata) {
     if (status == WGPURequestAdapterStatus_Success) {
         WGPUDeviceDescriptor deviceDesc = {};
+        gpu_timer_request_features(adapter, deviceDesc);
         wgpuAdapterRequestDevice(adapter, &deviceDesc, onDeviceRequestEnded, nullptr);
+        wgpuAdapterRelease(adapter); // The device keeps what it needs
     } else {
         std::cout << "[setup] Failed to get adapter." << std::endl;
     }
 }
 
-// --- The "Heavy" OpenMP-like Math Task (simulated with threads here) ---
+// --- The "Heavy" OpenMP-like Math Task (persistent thread pool) ---
+// Runs producer_kernels.h at the selected tier on the same work-stealing pool
+// as swarm.cpp (common/thread_pool.h), so no threads are spawned per frame.
+// Fills buffer[begin, end); the streaming mode generates a frame chunk by chunk
+void generate_range(std::vector<float>& buffer, size_t begin, size_t end, int seed) {
+    ProducerPrecision precision = producer_precision;
+    if (!producer_parallel) {
+        produce_range(buffer.data(), begin, end, seed, precision);
+        return;
+    }
+    ThreadPool& pool = ThreadPool::instance();
+    size_t grain = std::max<size_t>(4096, (end - begin) / (pool.size() * 4));
+    pool.parallel_for(begin, end, grain, [seed, precision, &buffer](size_t start, size_t stop) {
+        TRACE_SCOPE("produce-chunk");
+        produce_range(buffer.data(), start, stop, seed, precision);
+    });
+}
+
 void generate_data(std::vector<float>& buffer, int seed) {
-    // Simulate heavy math; we micro-parallelize using std::thread for portability
-    const int workers = 4; // approximate parallelism; in real PoC you'd use OpenMP
-    std::vector<std::thread> pool;
-    size_t chunk = buffer.size() / workers;
-    for (int w = 0; w < workers; ++w) {
-        size_t start = w * chunk;
-        size_t end = (w == workers -1) ? buffer.size() : start + chunk;
-        pool.emplace_back([start, end, seed, &buffer]() {
-            for (size_t i = start; i < end; ++i) {
-                float x = float(i) * 0.0001f + seed;
-                buffer[i] = std::sin(x) * std::cos(x) + std::sqrt(x);
-            }
-        });
+    TRACE_SCOPE("generate");
+    generate_range(buffer, 0, buffer.size(), seed);
+}
+
+// Same kernel through the OpenMP runtime, for comparing schedulers
+void generate_data_openmp(std::vector<float>& buffer, int seed) {
+    const long CHUNK = 4096;
+    long chunks = ((long)buffer.size() + CHUNK - 1) / CHUNK;
+    #pragma omp parallel for schedule(static)
+    for (long c = 0; c < chunks; ++c) {
+        size_t end = std::min(buffer.size(), (size_t)((c + 1) * CHUNK));
+        produce_range(buffer.data(), (size_t)(c * CHUNK), end, seed, producer_precision);
     }
-    for (auto &t : pool) t.join();
 }
 
-// Helper: non-blocking queue completion printer
-void queue_completion_printer(double submitTime) {
-    struct QD { double submit; } *qd = new QD{submitTime};
-    wgpuQueueOnSubmittedWorkDone(queue, [](WGPUQueueWorkDoneStatus status, void* userdata){ QD* d = (QD*)userdata; double end = emscripten_get_now(); std::cout << "[GPU] Completion after " << (end - d->submit) << " ms" << std::endl; delete d; }, qd);
+// Per-repetition budget for the GPU-bound modes, which take far longer per
+// sample than the CPU kernels
+BenchConfig upload_bench_config() {
+    BenchConfig cfg;
+    cfg.warmup = 1;
+    cfg.min_reps = 5;
+    cfg.max_reps = 30;
+    cfg.max_time_ms = 5000;
+    return cfg;
+}
+
+// Measured sin / cos error of each tier over the inputs the benchmark uses
+void print_producer_accuracy() {
+    float hi = DATA_SIZE * 0.0001f + 1000.0f;
+    for (ProducerPrecision p : PRODUCER_PRECISIONS) {
+        ProducerUlp u = producer_measure_ulp(p, 0.0f, hi, 200001);
+        std::cout << "[Producer] " << producer_precision_name(p) << ": max " << u.sin_max << " ULP (sin), "
+                  << u.cos_max << " ULP (cos), abs error " << u.abs_max << std::endl;
+    }
+}
+
+// Producer-only comparison: each tier on the thread pool, and the selected
+// tier on the pool vs OpenMP; no GPU involved
+void run_producer_comparison() {
+    BenchConfig cfg = upload_bench_config();
+    cfg.ops_per_rep = (double)DATA_SIZE; // Elements per second
+    int frame = 0;
+    std::cout << "[Producer] Thread pool threads: " << ThreadPool::instance().size()
+              << ", SIMD width: " << PRODUCER_SIMD_WIDTH << ", tier: " << producer_precision_name(producer_precision) << std::endl;
+    ProducerPrecision selected = producer_precision;
+    for (ProducerPrecision p : PRODUCER_PRECISIONS) {
+        producer_precision = p;
+        std::string name = std::string("upload/producer-pool/") + producer_precision_name(p);
+        bench_print(bench_run_timed(name.c_str(), [&] { generate_data(cpuBufferA, frame++); }, cfg));
+    }
+    producer_precision = selected;
+    bench_print(bench_run_timed("upload/producer-openmp", [&] { generate_data_openmp(cpuBufferA, frame++); }, cfg));
 }
 
 // --- The GPU Upload Thread (Consumer) ---
-void gpu_worker_thread() {
-    std::cout << "[GPU Thread] Started. Waiting for data..." << std::endl;
-    for (int frame = 0; frame < NUM_FRAMES; frame++) {
-        std::unique_lock<std::mutex> lk(mtx);
-        cv_upload.wait(lk, []{ return bufferA_ready_for_upload.load() || bufferB_ready_for_upload.load() || done.load(); });
-        if (done.load()) break;
-
-        if (bufferA_ready_for_upload.load()) {
-            // copy/upload A (writeBuffer)
-            lk.unlock();
-            double t0 = emscripten_get_now();
-            wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferA.data(), cpuBufferA.size() * sizeof(float));
-            double t1 = emscripten_get_now();
-            std::cout << "[GPU Thread] Uploaded A (writeBuffer) in " << (t1 - t0) << " ms" << std::endl;
-            queue_completion_printer(t1);
-            bufferA_ready_for_upload.store(false);
-            cv_compute.notify_one();
-        } else if (bufferB_ready_for_upload.load()) {
-            lk.unlock();
-            double t0 = emscripten_get_now();
-            wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferB.data(), cpuBufferB.size() * sizeof(float));
-            double t1 = emscripten_get_now();
-            std::cout << "[GPU Thread] Uploaded B (writeBuffer) in " << (t1 - t0) << " ms" << std::endl;
-            queue_completion_printer(t1);
-            bufferB_ready_for_upload.store(false);
-            cv_compute.notify_one();
-        }
+// Uploads each published frame with writeBuffer until the producer closes the ring
+template <typename Ring>
+void gpu_worker_thread(Ring* ring) {
+    trace_set_thread_name("uploader");
+    while (std::vector<float>* frame = ring->acquire_read()) {
+        TRACE_SCOPE("writeBuffer");
+        double t0 = emscripten_get_now();
+        wgpuQueueWriteBuffer(queue, gpuBuffer, 0, frame->data(), frame->size() * sizeof(float));
+        uploader_samples.push_back(emscripten_get_now() - t0);
+        ring->release();
     }
-    std::cout << "[GPU Thread] Finished." << std::endl;
 }
 
-// Staging upload helper (blocking until GPU completion)
+// Staging upload helper (blocking until GPU completion). gpuCompleteMs is the
+// GPU time of the staging -> gpuBuffer copy (see GpuTimer), -1 on timeout.
 bool staging_upload_and_wait(const float* data, size_t byteSize, double &uploadTimeMs, double &gpuCompleteMs) {
+    TRACE_SCOPE("staging-upload");
     // Create staging buffer
     WGPUBufferDescriptor stagingDesc = {};
     stagingDesc.size = byteSize;
     stagingDesc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
-    WGPUBuffer staging = wgpuDeviceCreateBuffer(device, &stagingDesc);
+    WGPUBuffer staging;
+    {
+        TRACE_SCOPE("create-staging");
+        staging = wgpuDeviceCreateBuffer(device, &stagingDesc);
+    }
 
     // Map async
     struct MapDone { bool done; } md{false};
-    wgpuBufferMapAsync(staging, WGPUMapMode_Write, 0, byteSize, [](WGPUBufferMapAsyncStatus status, void* userdata){ ((MapDone*)userdata)->done = true; }, &md);
-    int wait = 0; while (!md.done && wait < 1000) { emscripten_sleep(1); wait++; }
+    {
+        TRACE_SCOPE("map-wait");
+        wgpuBufferMapAsync(staging, WGPUMapMode_Write, 0, byteSize, [](WGPUBufferMapAsyncStatus status, void* userdata){ ((MapDone*)userdata)->done = true; }, &md);
+        int wait = 0; while (!md.done && wait < 1000) { emscripten_sleep(1); wait++; }
+    }
     if (!md.done) { wgpuBufferRelease(staging); return false; }
 
     void* ptr = wgpuBufferGetMappedRange(staging, 0, byteSize);
     double t_map = emscripten_get_now();
-    memcpy(ptr, data, byteSize);
-    wgpuBufferUnmap(staging);
+    {
+        TRACE_SCOPE("copy-unmap");
+        memcpy(ptr, data, byteSize);
+        wgpuBufferUnmap(staging);
+    }
     double t_unmap = emscripten_get_now();
 
-    // Copy staging -> gpuBuffer
-    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
-    wgpuCommandEncoderCopyBufferToBuffer(encoder, staging, 0, gpuBuffer, 0, byteSize);
-    WGPUCommandBuffer cb = wgpuCommandEncoderFinish(encoder, nullptr);
+    // Copy staging -> gpuBuffer, bracketed by timestamp markers
+    WGPUCommandEncoder encoder;
+    WGPUCommandBuffer cb;
+    {
+        TRACE_SCOPE("encode");
+        encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        gpuTimer.mark_begin(encoder);
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, staging, 0, gpuBuffer, 0, byteSize);
+        gpuTimer.mark_end(encoder);
+        gpuTimer.resolve(encoder);
+        cb = wgpuCommandEncoderFinish(encoder, nullptr);
+    }
 
-    double t_submit = emscripten_get_now();
-    wgpuQueueSubmit(queue, 1, &cb);
+    {
+        TRACE_SCOPE("submit");
+        wgpuQueueSubmit(queue, 1, &cb);
+    }
 
     // Wait for GPU completion
-    struct QDone { double submit; double end; bool done; } qd{ t_submit, 0.0, false };
-    wgpuQueueOnSubmittedWorkDone(queue, [](WGPUQueueWorkDoneStatus status, void* userdata){ QDone* d = (QDone*)userdata; d->end = emscripten_get_now(); d->done = true; }, &qd);
-    int wait2 = 0; while (!qd.done && wait2 < 10000) { emscripten_sleep(1); wait2++; }
-
-    double endTime = qd.done ? qd.end : -1.0;
+    GpuTiming gpu = gpuTimer.collect(10000.0);
     uploadTimeMs = (t_unmap - t_map);
-    gpuCompleteMs = (endTime > 0.0) ? (endTime - t_submit) : -1.0;
+    gpuCompleteMs = gpu.ok ? gpu.ms : -1.0;
 
     // cleanup
     wgpuCommandBufferRelease(cb);
+    wgpuCommandEncoderRelease(encoder);
     wgpuBufferRelease(staging);
 
-    return qd.done;
+    return gpu.ok;
 }
 
-// Serial variant (no uploader thread) for comparison
+// Serial variant (no uploader thread) for comparison. One repetition is one
+// frame: generate, then upload.
 void run_serial() {
-    double t0 = emscripten_get_now();
-    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
-        generate_data(cpuBufferA, frame);
+    int frame = 0;
+    bench_print(bench_run("upload/serial-writeBuffer", [&](BenchContext& ctx) {
+        double t0 = emscripten_get_now();
+        generate_data(cpuBufferA, frame++);
         double t_upload0 = emscripten_get_now();
-        wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferA.data(), cpuBufferA.size() * sizeof(float));
+        {
+            TRACE_SCOPE("writeBuffer");
+            wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferA.data(), cpuBufferA.size() * sizeof(float));
+        }
         double t_upload1 = emscripten_get_now();
-        std::cout << "[Serial] Frame " << frame << " upload took " << (t_upload1 - t_upload0) << " ms" << std::endl;
-    }
-    double t1 = emscripten_get_now();
-    std::cout << "[Serial] Total time: " << (t1 - t0) << " ms" << std::endl;
+        ctx.record("upload", t_upload1 - t_upload0);
+        return t_upload1 - t0;
+    }, upload_bench_config()));
 }
 
-// Staging-capable GPU uploader thread (uses staging_map -> copy -> submit)
-void gpu_worker_thread_staging() {
-    std::cout << "[GPU Thread (staging)] Started. Waiting for data..." << std::endl;
-    for (int frame = 0; frame < NUM_FRAMES; frame++) {
-        std::unique_lock<std::mutex> lk(mtx);
-        cv_upload.wait(lk, []{ return bufferA_ready_for_upload.load() || bufferB_ready_for_upload.load() || done.load(); });
-        if (done.load()) break;
-
-        if (bufferA_ready_for_upload.load()) {
-            lk.unlock();
-            double uploadMs, gpuMs;
-            bool ok = staging_upload_and_wait(cpuBufferA.data(), cpuBufferA.size() * sizeof(float), uploadMs, gpuMs);
-            if (ok) std::cout << "[GPU Thread (staging)] Uploaded A: map copy=" << uploadMs << " ms, GPU complete=" << gpuMs << " ms" << std::endl;
-            else std::cout << "[GPU Thread (staging)] FAILED to upload A via staging" << std::endl;
-            bufferA_ready_for_upload.store(false);
-            cv_compute.notify_one();
-        } else if (bufferB_ready_for_upload.load()) {
-            lk.unlock();
-            double uploadMs, gpuMs;
-            bool ok = staging_upload_and_wait(cpuBufferB.data(), cpuBufferB.size() * sizeof(float), uploadMs, gpuMs);
-            if (ok) std::cout << "[GPU Thread (staging)] Uploaded B: map copy=" << uploadMs << " ms, GPU complete=" << gpuMs << " ms" << std::endl;
-            else std::cout << "[GPU Thread (staging)] FAILED to upload B via staging" << std::endl;
-            bufferB_ready_for_upload.store(false);
-            cv_compute.notify_one();
+// Serial variant uploading through a fresh staging buffer every frame
+void run_serial_staging() {
+    int frame = 0;
+    bench_print(bench_run("upload/serial-staging", [&](BenchContext& ctx) {
+        double t0 = emscripten_get_now();
+        generate_data(cpuBufferA, frame++);
+        double uploadMs = 0.0, gpuMs = 0.0;
+        bool ok = staging_upload_and_wait(cpuBufferA.data(), cpuBufferA.size() * sizeof(float), uploadMs, gpuMs);
+        if (ok) {
+            ctx.record("map-copy", uploadMs);
+            ctx.record("gpu", gpuMs);
+        } else {
+            std::cout << "[Serial (staging)] Frame " << frame << " FAILED" << std::endl;
         }
+        return emscripten_get_now() - t0;
+    }, upload_bench_config()));
+}
+
+// Uploads through a persistent staging belt (common/staging_belt.h). The data
+// is generated once, so the sample is the per-frame upload cost alone: write
+// into a mapped chunk, submit the copy, recall the chunk. Warmup runs long
+// enough to create every chunk, so the timed frames allocate nothing.
+// opsPerSec is bytes/sec.
+void run_staging_belt() {
+    const uint64_t byteSize = DATA_SIZE * sizeof(float);
+    const int MAX_CHUNKS = 3;
+    StagingBelt belt;
+    belt.init(device, byteSize, MAX_CHUNKS);
+    generate_data(cpuBufferA, 0);
+
+    BenchConfig cfg = upload_bench_config();
+    cfg.warmup = MAX_CHUNKS + 1;
+    cfg.max_reps = 100;
+    cfg.ops_per_rep = (double)byteSize;
+    StagingBeltStats warm;
+    BenchReport report = bench_run("upload/staging-belt", [&](BenchContext& ctx) {
+        if (!ctx.warmup() && warm.created == 0) warm = belt.stats();
+        double waited = belt.stats().map_wait_ms;
+        TRACE_SCOPE("belt-frame");
+        double t0 = emscripten_get_now();
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        bool ok = belt.write(encoder, gpuBuffer, 0, cpuBufferA.data(), byteSize);
+        belt.finish();
+        WGPUCommandBuffer cb = wgpuCommandEncoderFinish(encoder, nullptr);
+        wgpuQueueSubmit(queue, 1, &cb);
+        belt.recall();
+        double ms = emscripten_get_now() - t0;
+        wgpuCommandBufferRelease(cb);
+        wgpuCommandEncoderRelease(encoder);
+        if (!ok) std::cout << "[Staging belt] FAILED to allocate a staging chunk" << std::endl;
+        ctx.record("map-wait", belt.stats().map_wait_ms - waited);
+        return ms;
+    }, cfg);
+    bench_print(report);
+
+    StagingBeltStats st = belt.stats();
+    std::cout << "[upload/staging-belt] " << (double)byteSize / (report.stats.median * 1e6) << " GB/s, "
+              << st.chunks << " chunks (" << st.created - warm.created << " created after warmup), "
+              << st.reused << " reuses, " << st.map_waits << " map waits";
+    if (st.map_failures) std::cout << ", " << st.map_failures << " failed maps";
+    std::cout << std::endl;
+    belt.release();
+}
+
+// Staging-capable GPU uploader thread (uses staging_map -> copy -> submit)
+template <typename Ring>
+void gpu_worker_thread_staging(Ring* ring) {
+    trace_set_thread_name("uploader");
+    while (std::vector<float>* frame = ring->acquire_read()) {
+        double uploadMs, gpuMs;
+        bool ok = staging_upload_and_wait(frame->data(), frame->size() * sizeof(float), uploadMs, gpuMs);
+        if (ok) uploader_samples.push_back(uploadMs);
+        else std::cout << "[GPU Thread (staging)] FAILED to upload via staging" << std::endl;
+        ring->release();
+    }
+}
+
+// Producer side of both pipelined modes: generates NUM_FRAMES frames into
+// the ring while `uploader` drains it on its own thread. The producer only
+// waits when all ring slots are still queued for upload.
+template <typename Ring>
+void run_pipelined(Ring& ring, void (*uploader)(Ring*)) {
+    ring.reset();
+    std::thread uploaderThread(uploader, &ring);
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        TRACE_SCOPE("produce-frame");
+        std::vector<float>& slot = ring.acquire_write();
+        generate_data(slot, frame);
+        ring.publish();
     }
-    std::cout << "[GPU Thread (staging)] Finished." << std::endl;
+
+    ring.close();
+    uploaderThread.join();
 }
 
 // Pipelined variant using writeBuffer (existing) - unchanged name for backwards compatibility
-void run_pipelined_writeBuffer() {
-    // Start GPU worker
-    std::thread uploader(gpu_worker_thread);
+template <typename Ring>
+void run_pipelined_writeBuffer(Ring& ring) {
+    run_pipelined(ring, gpu_worker_thread<Ring>);
+}
 
-    double t0 = emscripten_get_now();
+// Pipelined variant using staging uploads
+template <typename Ring>
+void run_pipelined_staging(Ring& ring) {
+    run_pipelined(ring, gpu_worker_thread_staging<Ring>);
+}
 
-    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
-        // Compute A
-        generate_data(cpuBufferA, frame);
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            bufferA_ready_for_upload.store(true);
+// One repetition of a pipelined mode is a full NUM_FRAMES run through a
+// ring of `depth` slots; the sample is ms per frame, with the uploader's
+// per-frame times recorded as "upload" and the ring's wait time per frame as
+// "producer-stall" / "consumer-starve". opsPerSec is frames per second.
+// `ring` is sized and reused by every repetition.
+template <typename Ring>
+BenchReport bench_pipelined(const char* mode, Ring& ring, void (*run_once)(Ring&)) {
+    size_t depth = ring.depth();
+    for (size_t i = 0; i < ring.depth(); ++i) ring.slot(i).resize(DATA_SIZE);
+
+    BenchConfig cfg = upload_bench_config();
+    cfg.min_reps = 3;
+    cfg.max_reps = 10;
+    cfg.ops_per_rep = 1.0;
+    uint64_t stalls = 0, starves = 0;
+    std::string name = std::string(mode) + "/depth-" + std::to_string(depth);
+    BenchReport report = bench_run(name.c_str(), [&](BenchContext& ctx) {
+        uploader_samples.clear();
+        double ms = bench_time_ms([&] { run_once(ring); }) / NUM_FRAMES;
+        SpscRingStats rs = ring.stats();
+        for (double u : uploader_samples) ctx.record("upload", u);
+        ctx.record("producer-stall", rs.producer_stall_ms / NUM_FRAMES);
+        ctx.record("consumer-starve", rs.consumer_starve_ms / NUM_FRAMES);
+        if (!ctx.warmup()) {
+            stalls += rs.producer_stalls;
+            starves += rs.consumer_starves;
         }
-        cv_upload.notify_one();
+        return ms;
+    }, cfg);
+    bench_print(report);
+    std::cout << "[" << name << "] producer stalls " << stalls << ", consumer starves " << starves
+              << " over " << report.stats.samples * NUM_FRAMES << " frames" << std::endl;
+    return report;
+}
 
-        // Compute B while A is uploading
-        generate_data(cpuBufferB, frame + 1);
+// `depth` alone, or every PIPELINE_DEPTHS entry when depth is 0
+std::vector<size_t> pipeline_depths(size_t depth) {
+    if (depth > 0) return {depth};
+    return std::vector<size_t>(std::begin(PIPELINE_DEPTHS), std::end(PIPELINE_DEPTHS));
+}
 
-        // Wait for A to finish uploading before we overwrite it
-        {
-            std::unique_lock<std::mutex> lk(mtx);
-            cv_compute.wait(lk, []{ return !bufferA_ready_for_upload.load(); });
-        }
+// Runs a pipelined mode at `depth`, or across PIPELINE_DEPTHS when depth is 0
+void bench_pipelined_depths(const char* mode, size_t depth, void (*run_once)(UploadRing&)) {
+    for (size_t d : pipeline_depths(depth)) {
+        UploadRing ring(d);
+        bench_pipelined(mode, ring, run_once);
+    }
+}
 
-        // Signal B
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            bufferB_ready_for_upload.store(true);
+// --- Synchronisation Cost ---
+// Runs each pipelined mode through the lock-free SpscRing and through the
+// mutex + condvar LockedRing at the same depths. The bench lines give the
+// wall-time difference; the [sync] table printed at exit breaks the locked
+// side down per primitive (lock acquire time, condvar sleep time, spurious
+// wakeups, notify-to-wake latency), i.e. what the lock-free ring saves.
+void run_sync_comparison(size_t depth) {
+    struct Mode { const char* spsc; const char* locked; const char* prims;
+                  void (*spscRun)(UploadRing&); void (*lockedRun)(LockedUploadRing&); };
+    const Mode modes[] = {
+        {"upload/pipelined-writeBuffer", "upload/locked-writeBuffer", "writeBuffer",
+         run_pipelined_writeBuffer<UploadRing>, run_pipelined_writeBuffer<LockedUploadRing>},
+        {"upload/pipelined-staging", "upload/locked-staging", "staging",
+         run_pipelined_staging<UploadRing>, run_pipelined_staging<LockedUploadRing>},
+    };
+    for (const Mode& m : modes) {
+        for (size_t d : pipeline_depths(depth)) {
+            UploadRing spsc(d);
+            BenchReport lockFree = bench_pipelined(m.spsc, spsc, m.spscRun);
+            // One set of primitives per mode and depth, so each gets its own rows
+            LockedUploadRing locked(d, std::string(m.prims) + "/depth-" + std::to_string(d));
+            BenchReport baseline = bench_pipelined(m.locked, locked, m.lockedRun);
+            std::printf("[sync] %s depth %zu: lock-free %.3f ms/frame, locked %.3f ms/frame (%+.3f ms/frame)\n",
+                        m.prims, d, lockFree.stats.mean, baseline.stats.mean,
+                        baseline.stats.mean - lockFree.stats.mean);
         }
-        cv_upload.notify_one();
+    }
+}
 
-        // Wait for B
-        {
-            std::unique_lock<std::mutex> lk(mtx);
-            cv_compute.wait(lk, []{ return !bufferB_ready_for_upload.load(); });
+// --- Streaming Uploads ---
+// Each frame is generated chunk by chunk (the pool splits each chunk), and an
+// uploader thread writes every finished chunk straight away, so the first bytes
+// reach the GPU after one chunk instead of a whole frame. Chunks pass through
+// an SPSC ring of descriptors; the data stays in cpuBufferA. A ring no deeper
+// than the chunks per frame guarantees chunk c of the previous frame has been
+// uploaded before the producer overwrites it.
+
+// Chunk sizes swept by --stream; the last one is a whole frame (no streaming)
+const size_t STREAM_CHUNK_KB[] = {64, 256, 1024, 4096, DATA_SIZE * sizeof(float) / 1024};
+const size_t STREAM_DEFAULT_CHUNK_KB = 256;
+const size_t STREAM_RING_DEPTH = 4;
+
+struct StreamChunk {
+    size_t begin, end;      // Elements of cpuBufferA
+    int frame;
+    double frameStart;
+    bool last;
+};
+
+typedef SpscRing<StreamChunk> ChunkRing;
+
+// Per-frame latencies of the last streaming run, measured from the frame's
+// start to the end of its first / last writeBuffer; only the uploader thread
+// appends, main reads after join()
+std::vector<double> stream_first_upload_ms;
+std::vector<double> stream_frame_latency_ms;
+
+void stream_uploader_thread(ChunkRing* ring) {
+    trace_set_thread_name("uploader");
+    int frame = -1;
+    while (StreamChunk* chunk = ring->acquire_read()) {
+        TRACE_SCOPE("writeBuffer-chunk");
+        wgpuQueueWriteBuffer(queue, gpuBuffer, chunk->begin * sizeof(float), cpuBufferA.data() + chunk->begin,
+                             (chunk->end - chunk->begin) * sizeof(float));
+        double now = emscripten_get_now();
+        if (chunk->frame != frame) {
+            frame = chunk->frame;
+            stream_first_upload_ms.push_back(now - chunk->frameStart);
         }
+        if (chunk->last) stream_frame_latency_ms.push_back(now - chunk->frameStart);
+        ring->release();
     }
+}
 
-    // Cleanup
-    {
-        std::lock_guard<std::mutex> lk(mtx);
-        done.store(true);
+void run_streaming(ChunkRing& ring, size_t chunkElems) {
+    ring.reset();
+    std::thread uploader(stream_uploader_thread, &ring);
+
+    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
+        double frameStart = emscripten_get_now();
+        for (size_t begin = 0; begin < DATA_SIZE; begin += chunkElems) {
+            size_t end = std::min(DATA_SIZE, begin + chunkElems);
+            TRACE_SCOPE("stream-chunk");
+            StreamChunk& chunk = ring.acquire_write();
+            generate_range(cpuBufferA, begin, end, frame);
+            chunk = StreamChunk{begin, end, frame, frameStart, end == DATA_SIZE};
+            ring.publish();
+        }
     }
-    cv_upload.notify_one();
+
+    ring.close();
     uploader.join();
+}
 
-    double t1 = emscripten_get_now();
-    std::cout << "[Pipelined (writeBuffer)] Total time: " << (t1 - t0) << " ms" << std::endl;
+struct StreamPoint {
+    size_t chunkKB;
+    double frameMs;         // Medians
+    double firstUploadMs;
+    double latencyMs;
+};
+
+// One repetition is NUM_FRAMES streamed frames; the sample is ms per frame
+// (opsPerSec is bytes/sec), with per-frame "first-upload" and "frame-latency"
+StreamPoint bench_streaming(size_t chunkKB) {
+    size_t chunkElems = std::max<size_t>(1, chunkKB * 1024 / sizeof(float));
+    size_t chunks = (DATA_SIZE + chunkElems - 1) / chunkElems;
+    ChunkRing ring(std::min(STREAM_RING_DEPTH, chunks));
+
+    BenchConfig cfg = upload_bench_config();
+    cfg.min_reps = 3;
+    cfg.max_reps = 10;
+    cfg.ops_per_rep = (double)(DATA_SIZE * sizeof(float));
+    std::string name = "upload/stream/chunk-" + std::to_string(chunkKB) + "KB";
+    BenchReport report = bench_run(name.c_str(), [&](BenchContext& ctx) {
+        stream_first_upload_ms.clear();
+        stream_frame_latency_ms.clear();
+        double ms = bench_time_ms([&] { run_streaming(ring, chunkElems); }) / NUM_FRAMES;
+        for (double v : stream_first_upload_ms) ctx.record("first-upload", v);
+        for (double v : stream_frame_latency_ms) ctx.record("frame-latency", v);
+        return ms;
+    }, cfg);
+    bench_print(report);
+    return StreamPoint{chunkKB, report.stats.median, report.metric("first-upload").median,
+                       report.metric("frame-latency").median};
 }
 
-// Pipelined variant using staging uploads
-void run_pipelined_staging() {
-    // reset done flag
-    done.store(false);
-    std::thread uploader(gpu_worker_thread_staging);
+// Sweeps STREAM_CHUNK_KB, or runs one chunk size when chunkKB > 0
+void run_stream_sweep(size_t chunkKB) {
+    std::vector<StreamPoint> points;
+    if (chunkKB > 0) points.push_back(bench_streaming(chunkKB));
+    else for (size_t kb : STREAM_CHUNK_KB) points.push_back(bench_streaming(kb));
+
+    std::cout << "Streaming uploads (writeBuffer, " << NUM_FRAMES << " frames per sample):" << std::endl;
+    std::cout << "  chunk KB  ms/frame  first upload ms  frame latency ms" << std::endl;
+    for (const StreamPoint& p : points) {
+        char line[128];
+        std::snprintf(line, sizeof(line), "  %8zu %9.3f %16.3f %17.3f", p.chunkKB, p.frameMs, p.firstUploadMs, p.latencyMs);
+        std::cout << line << std::endl;
+    }
+}
 
-    double t0 = emscripten_get_now();
+// --- Delta Uploads ---
+// Only the pages the producer dirtied are uploaded, as the coalesced ranges
+// from common/dirty_ranges.h, either as one writeBuffer per range or as one
+// staging-belt copy per range in a single submit.
+
+// lowbias32 integer hash (Wellons), used to pick dirty pages per frame
+uint32_t page_hash(uint32_t x) {
+    x ^= x >> 16; x *= 0x7feb352dU;
+    x ^= x >> 15; x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
 
-    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
-        generate_data(cpuBufferA, frame);
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            bufferA_ready_for_upload.store(true);
-        }
-        cv_upload.notify_one();
+// Dirties about `fraction` of the pages, scattered uniformly: the worst case
+// for the number of ranges, and so what the coalescing gap trades against
+void mark_dirty_pages(DirtyRanges& dirty, double fraction, uint32_t frame) {
+    if (fraction >= 1.0) {
+        dirty.mark_all();
+        return;
+    }
+    uint32_t threshold = (uint32_t)(fraction * 4294967295.0);
+    for (uint64_t p = 0; p < dirty.page_count(); p++) {
+        if (page_hash((uint32_t)p * 0x9e3779b9U + frame) < threshold) dirty.mark_page(p);
+    }
+}
 
-        generate_data(cpuBufferB, frame + 1);
+void upload_ranges_writeBuffer(const std::vector<DirtyRange>& ranges, StagingBelt&) {
+    const uint8_t* base = (const uint8_t*)cpuBufferA.data();
+    for (const DirtyRange& r : ranges) {
+        wgpuQueueWriteBuffer(queue, gpuBuffer, r.offset, base + r.offset, r.size);
+    }
+}
 
-        {
-            std::unique_lock<std::mutex> lk(mtx);
-            cv_compute.wait(lk, []{ return !bufferA_ready_for_upload.load(); });
+void upload_ranges_staging(const std::vector<DirtyRange>& ranges, StagingBelt& belt) {
+    const uint8_t* base = (const uint8_t*)cpuBufferA.data();
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    for (const DirtyRange& r : ranges) belt.write(encoder, gpuBuffer, r.offset, base + r.offset, r.size);
+    belt.finish();
+    WGPUCommandBuffer cb = wgpuCommandEncoderFinish(encoder, nullptr);
+    wgpuQueueSubmit(queue, 1, &cb);
+    belt.recall();
+    wgpuCommandBufferRelease(cb);
+    wgpuCommandEncoderRelease(encoder);
+}
+
+struct DeltaMethod {
+    const char* name;
+    void (*upload)(const std::vector<DirtyRange>& ranges, StagingBelt& belt);
+};
+
+const DeltaMethod DELTA_METHODS[] = {
+    {"writeBuffer", upload_ranges_writeBuffer},
+    {"staging-belt", upload_ranges_staging},
+};
+
+struct DeltaPoint {
+    double fraction;
+    uint64_t gap;
+    double ms;          // Median; coalesce + upload
+    double ranges;      // Mean per frame
+    double bytes;       // Mean per frame, clean gap pages included
+};
+
+// One repetition marks a fresh set of dirty pages (untimed), then times
+// coalescing plus the upload. fraction < 0 is the full-buffer baseline: one
+// range, no tracking.
+DeltaPoint bench_delta(const DeltaMethod& method, StagingBelt& belt, DirtyRanges& dirty, double fraction, uint64_t gap) {
+    BenchConfig cfg = upload_bench_config();
+    cfg.warmup = 4; // Lets the belt create its chunks
+    cfg.max_reps = 50;
+    cfg.max_time_ms = 1000;
+    std::string name = std::string("upload/delta-") + method.name;
+    if (fraction < 0) name += "/full";
+    else name += "/dirty-" + std::to_string((int)std::lround(fraction * 100)) + "%/gap-" + std::to_string(gap);
+
+    uint32_t frame = 0;
+    double ranges = 0, bytes = 0;
+    std::vector<DirtyRange> full = { DirtyRange{0, dirty.size()} };
+    BenchReport report = bench_run(name.c_str(), [&](BenchContext& ctx) {
+        dirty.clear();
+        if (fraction >= 0) mark_dirty_pages(dirty, fraction, frame++);
+        double t0 = emscripten_get_now();
+        const std::vector<DirtyRange>& todo = fraction < 0 ? full : dirty.coalesce(gap);
+        method.upload(todo, belt);
+        double ms = emscripten_get_now() - t0;
+        if (!ctx.warmup()) {
+            ranges += (double)todo.size();
+            for (const DirtyRange& r : todo) bytes += (double)r.size;
         }
+        return ms;
+    }, cfg);
+    bench_print(report);
+
+    DeltaPoint p;
+    p.fraction = fraction;
+    p.gap = gap;
+    p.ms = report.stats.median;
+    p.ranges = ranges / report.stats.samples;
+    p.bytes = bytes / report.stats.samples;
+    return p;
+}
 
-        {
-            std::lock_guard<std::mutex> lk(mtx);
-            bufferB_ready_for_upload.store(true);
+// Sweeps dirty fraction x coalescing gap per upload method and reports where
+// a delta upload stops beating a full-buffer upload
+void run_delta_sweep() {
+    generate_data(cpuBufferA, 0);
+    DirtyRanges dirty(DATA_SIZE * sizeof(float));
+    for (const DeltaMethod& method : DELTA_METHODS) {
+        StagingBelt belt;
+        belt.init(device, DATA_SIZE * sizeof(float), 3);
+        DeltaPoint full = bench_delta(method, belt, dirty, -1.0, 0);
+        std::vector<DeltaPoint> points;
+        for (uint64_t gap : DELTA_MAX_GAP_PAGES) {
+            for (double fraction : DELTA_DIRTY_FRACTIONS) points.push_back(bench_delta(method, belt, dirty, fraction, gap));
+        }
+        belt.release();
+
+        std::cout << "Delta uploads (" << method.name << "), full upload " << full.ms << " ms:" << std::endl;
+        std::cout << "  dirty%  gap  ranges     MB      ms  vs full" << std::endl;
+        for (const DeltaPoint& p : points) {
+            char line[128];
+            std::snprintf(line, sizeof(line), "  %5.0f%% %4llu %7.0f %6.2f %7.3f  %6.2fx",
+                          p.fraction * 100, (unsigned long long)p.gap, p.ranges, p.bytes / 1048576.0, p.ms,
+                          p.ms > 0 ? full.ms / p.ms : 0.0);
+            std::cout << line << std::endl;
+        }
+        for (uint64_t gap : DELTA_MAX_GAP_PAGES) {
+            // Largest swept fraction below the first one where delta is no faster
+            double crossover = -1;
+            for (const DeltaPoint& p : points) {
+                if (p.gap != gap) continue;
+                if (p.ms >= full.ms) break;
+                crossover = p.fraction;
+            }
+            std::cout << "  gap " << gap << ": ";
+            if (crossover < 0) std::cout << "full upload wins at every dirty fraction" << std::endl;
+            else std::cout << "delta wins up to " << crossover * 100 << "% dirty" << std::endl;
+            std::cout << "RESULT: {\"name\":\"upload/delta-" << method.name << "/gap-" << gap
+                      << "/crossover\",\"dirtyFraction\":" << (crossover < 0 ? 0.0 : crossover) << "}" << std::endl;
         }
-        cv_upload.notify_one();
+    }
+}
 
-        {
-            std::unique_lock<std::mutex> lk(mtx);
-            cv_compute.wait(lk, []{ return !bufferB_ready_for_upload.load(); });
+// Producer speed vs upload cost. Each tier runs on one thread and on the pool,
+// timed alone and then pipelined with writeBuffer uploads (ring depth 2). While
+// the producer is slower than the upload the frame time follows it; once it
+// is faster, the frame time is bounded by the upload.
+void run_producer_crossover() {
+    BenchConfig cfg = upload_bench_config();
+    generate_data(cpuBufferA, 0);
+    BenchReport upload = bench_run_timed("upload/crossover/writeBuffer", [&] {
+        wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferA.data(), cpuBufferA.size() * sizeof(float));
+    }, cfg);
+    bench_print(upload);
+
+    struct Row { std::string producer; double produceMs; double frameMs; };
+    std::vector<Row> rows;
+    ProducerPrecision selected = producer_precision;
+    for (bool parallel : {false, true}) {
+        for (ProducerPrecision p : PRODUCER_PRECISIONS) {
+            producer_precision = p;
+            producer_parallel = parallel;
+            std::string producer = std::string(producer_precision_name(p)) + (parallel ? "-pool" : "-serial");
+            int frame = 0;
+            BenchReport produce = bench_run_timed(("upload/crossover/produce-" + producer).c_str(),
+                                                  [&] { generate_data(cpuBufferA, frame++); }, cfg);
+            bench_print(produce);
+            UploadRing ring(2);
+            BenchReport piped = bench_pipelined(("upload/crossover/pipelined-" + producer).c_str(), ring,
+                                                run_pipelined_writeBuffer<UploadRing>);
+            rows.push_back(Row{producer, produce.stats.median, piped.stats.median});
         }
     }
+    producer_precision = selected;
+    producer_parallel = true;
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) { return a.produceMs > b.produceMs; });
+    std::cout << "Producer vs upload (writeBuffer " << upload.stats.median << " ms/frame):" << std::endl;
+    std::cout << "  producer        produce ms  pipelined ms/frame  bound" << std::endl;
+    const Row* firstUploadBound = nullptr;
+    for (const Row& r : rows) {
+        bool uploadBound = r.produceMs < upload.stats.median;
+        if (uploadBound && !firstUploadBound) firstUploadBound = &r;
+        char line[128];
+        std::snprintf(line, sizeof(line), "  %-14s %11.3f %19.3f  %s", r.producer.c_str(), r.produceMs, r.frameMs,
+                      uploadBound ? "upload" : "compute");
+        std::cout << line << std::endl;
+    }
+    if (firstUploadBound) std::cout << "  Upload-bound from " << firstUploadBound->producer << " onwards" << std::endl;
+    else std::cout << "  Compute-bound for every producer" << std::endl;
+    std::cout << "RESULT: {\"name\":\"upload/crossover\",\"uploadMs\":" << upload.stats.median
+              << ",\"firstUploadBound\":\"" << (firstUploadBound ? firstUploadBound->producer : "") << "\"}" << std::endl;
+}
 
+// --- Allocation Probes ---
+// Heap traffic per frame of each upload path (common/alloc_tracker.h), then
+// the delta upload's per-frame range list built three ways: in the
+// DirtyRanges-owned vector (persistent), in a fresh std::vector per frame
+// (heap), and in a vector on a FrameArena reset every frame (arena). The
+// scratch benchmarks time building and reading the list only, no GPU.
+const double SCRATCH_DIRTY_FRACTION = 0.25;
+
+enum class ScratchKind { Persistent, Heap, Arena };
+
+template <typename Vec>
+uint64_t sum_range_bytes(const Vec& ranges) {
+    uint64_t bytes = 0;
+    for (const DirtyRange& r : ranges) bytes += r.size;
+    return bytes;
+}
+
+uint64_t build_delta_scratch(ScratchKind kind, DirtyRanges& dirty, FrameArena& arena) {
+    if (kind == ScratchKind::Persistent) return sum_range_bytes(dirty.coalesce(0));
+    if (kind == ScratchKind::Heap) {
+        std::vector<DirtyRange> ranges;
+        dirty.coalesce_into(ranges, 0);
+        return sum_range_bytes(ranges);
+    }
+    uint64_t bytes;
     {
-        std::lock_guard<std::mutex> lk(mtx);
-        done.store(true);
+        std::vector<DirtyRange, ArenaAllocator<DirtyRange>> ranges{ArenaAllocator<DirtyRange>(arena)};
+        dirty.coalesce_into(ranges, 0);
+        bytes = sum_range_bytes(ranges);
     }
-    cv_upload.notify_one();
-    uploader.join();
+    arena.reset();
+    return bytes;
+}
 
-    double t1 = emscripten_get_now();
-    std::cout << "[Pipelined (staging)] Total time: " << (t1 - t0) << " ms" << std::endl;
+void run_alloc_probes() {
+    const uint64_t byteSize = DATA_SIZE * sizeof(float);
+    generate_data(cpuBufferA, 0);
+    int frame = 0;
+    alloc_probe("upload/producer", 20, "frame", [&] { generate_data(cpuBufferA, frame++); });
+    alloc_probe("upload/serial-writeBuffer", 20, "frame", [&] {
+        wgpuQueueWriteBuffer(queue, gpuBuffer, 0, cpuBufferA.data(), byteSize);
+    });
+    alloc_probe("upload/serial-staging", 10, "frame", [&] {
+        double uploadMs, gpuMs;
+        staging_upload_and_wait(cpuBufferA.data(), byteSize, uploadMs, gpuMs);
+    });
+
+    StagingBelt belt;
+    belt.init(device, byteSize, 3);
+    auto beltFrame = [&] {
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+        belt.write(encoder, gpuBuffer, 0, cpuBufferA.data(), byteSize);
+        belt.finish();
+        WGPUCommandBuffer cb = wgpuCommandEncoderFinish(encoder, nullptr);
+        wgpuQueueSubmit(queue, 1, &cb);
+        belt.recall();
+        wgpuCommandBufferRelease(cb);
+        wgpuCommandEncoderRelease(encoder);
+    };
+    for (int i = 0; i < 4; i++) beltFrame(); // Creates every chunk
+    alloc_probe("upload/staging-belt", 20, "frame", beltFrame);
+    belt.release();
+
+    DirtyRanges dirty(byteSize);
+    mark_dirty_pages(dirty, SCRATCH_DIRTY_FRACTION, 1);
+    FrameArena arena(64 << 10);
+    const struct { ScratchKind kind; const char* name; } kinds[] = {
+        {ScratchKind::Persistent, "upload/scratch-persistent"},
+        {ScratchKind::Heap, "upload/scratch-heap"},
+        {ScratchKind::Arena, "upload/scratch-arena"},
+    };
+    double heapMs = 0.0;
+    for (const auto& k : kinds) {
+        volatile uint64_t sink = 0;
+        BenchReport report = bench_run_timed(k.name, [&] { sink = build_delta_scratch(k.kind, dirty, arena); });
+        bench_print(report);
+        alloc_probe(k.name, 100, "frame", [&] { sink = build_delta_scratch(k.kind, dirty, arena); });
+        if (k.kind == ScratchKind::Heap) heapMs = report.stats.median;
+        std::cout << "[" << k.name << "] " << dirty.coalesce(0).size() << " ranges";
+        if (heapMs > 0.0 && k.kind == ScratchKind::Arena) std::cout << ", " << heapMs / report.stats.median << "x vs heap";
+        std::cout << std::endl;
+    }
+    std::cout << "[upload/scratch-arena] arena " << arena.capacity() << " B, high water " << arena.high_water()
+              << " B, " << arena.overflows() << " overflow allocations" << std::endl;
 }
-int main() {
+
+// Usage: upload_benchmark [--depth N] [--delta | --crossover | --stream | --alloc | --sync]
+//                         [--chunk KB] [--precision exact|high|fast] [--trace FILE]
+// --depth runs the pipelined modes at one ring depth instead of sweeping;
+// --delta runs only the delta-upload sweep, --crossover only the producer vs
+// upload sweep, --stream only the streaming chunk-size sweep. --chunk sets
+// the streaming chunk size (one size instead of the sweep). --precision picks
+// the producer tier (default high). --alloc runs only the allocation probes.
+// --sync runs only the lock-free vs mutex + condvar handoff comparison; the
+// per-primitive [sync] table is printed at exit (common/sync_stats.h).
+// --delta, --crossover, --stream, --alloc and --sync are exclusive: giving
+// more than one prints the usage and exits 1. With none, the default run
+// covers the producer, serial, staging-belt, pipelined and streaming modes.
+// --trace writes a Chrome trace of every thread (common/trace.h) on exit.
+int main(int argc, char** argv) {
+    size_t depth = 0;
+    bool delta = false;
+    bool crossover = false;
+    bool stream = false;
+    bool alloc = false;
+    bool sync = false;
+    size_t chunkKB = 0;
+    const char* tracePath = nullptr;
+    const char* usage = "usage: upload_benchmark [--depth N] [--delta | --crossover | --stream | --alloc | --sync] "
+                        "[--chunk KB] [--precision exact|high|fast] [--trace FILE]";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) depth = (size_t)std::atoi(argv[++i]);
+        else if (arg == "--delta") delta = true;
+        else if (arg == "--crossover") crossover = true;
+        else if (arg == "--stream") stream = true;
+        else if (arg == "--alloc") alloc = true;
+        else if (arg == "--sync") sync = true;
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (arg == "--chunk" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) chunkKB = (size_t)std::atoi(argv[++i]);
+        else if (arg == "--precision" && i + 1 < argc && parse_producer_precision(argv[i + 1], producer_precision)) ++i;
+        else {
+            std::cout << usage << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (delta + crossover + stream + alloc + sync > 1) {
+        std::cout << "--delta, --crossover, --stream, --alloc and --sync each run one mode; pick one" << std::endl;
+        std::cout << usage << std::endl;
+        return 1;
+    }
+
     std::cout << "--- UPLOAD STRATEGY BENCHMARK (PoC) ---" << std::endl;
+    // Chrome trace of every thread, written when main returns
+    TraceSession trace(tracePath);
+    // Contention table for every instrumented mutex / condvar that was used
+    SyncSummary syncSummary;
 
-    // Allocate buffers
+    // Allocate buffers (ring slots are allocated per pipelined run)
     cpuBufferA.resize(DATA_SIZE);
-    cpuBufferB.resize(DATA_SIZE);
 
     // Request adapter/device
     WGPUInstanceDescriptor desc = {};
@@ -314,6 +897,7 @@ int main() {
         std::cout << "Failed to obtain GPU device. Exiting." << std::endl;
         return 1;
     }
+    wgpuInstanceRelease(instance);
 
     // Create GPU buffer
     WGPUBufferDescriptor bufDesc = {};
@@ -321,33 +905,73 @@ int main() {
     bufDesc.usage = WGPUBufferUsage_CopyDst | WGPUBufferUsage_Storage;
     gpuBuffer = wgpuDeviceCreateBuffer(device, &bufDesc);
 
+    gpuTimer.init(device, queue);
+    std::cout << "[setup] GPU timing: " << gpuTimer.source() << std::endl;
+
+    print_producer_accuracy();
+
+    if (crossover) {
+        std::cout << "Running producer vs upload crossover..." << std::endl;
+        run_producer_crossover();
+        std::cout << "Benchmark complete." << std::endl;
+        return 0;
+    }
+
+    if (stream) {
+        std::cout << "Running streaming-upload sweep..." << std::endl;
+        run_stream_sweep(chunkKB);
+        std::cout << "Benchmark complete." << std::endl;
+        return 0;
+    }
+
+    if (alloc) {
+        std::cout << "Running allocation probes..." << std::endl;
+        run_alloc_probes();
+        std::cout << "Benchmark complete." << std::endl;
+        return 0;
+    }
+
+    if (sync) {
+        std::cout << "Running lock-free vs locked handoff comparison..." << std::endl;
+        run_sync_comparison(depth);
+        std::cout << "Benchmark complete." << std::endl;
+        return 0;
+    }
+
+    if (delta) {
+        std::cout << "Running delta-upload sweep..." << std::endl;
+        run_delta_sweep();
+        std::cout << "Benchmark complete." << std::endl;
+        return 0;
+    }
+
+    // Producer scheduler comparison
+    std::cout << "Running producer benchmark (thread pool vs OpenMP)..." << std::endl;
+    run_producer_comparison();
+
     // Run serial (writeBuffer)
     std::cout << "Running serial benchmark (writeBuffer)..." << std::endl;
     run_serial();
 
     // Run serial (staging)
     std::cout << "Running serial benchmark (staging)..." << std::endl;
-    // perform a staging-based serial test
-    double s_t0 = emscripten_get_now();
-    for (int frame = 0; frame < NUM_FRAMES; ++frame) {
-        generate_data(cpuBufferA, frame);
-        double uploadMs = 0.0, gpuMs = 0.0;
-        bool ok = staging_upload_and_wait(cpuBufferA.data(), cpuBufferA.size() * sizeof(float), uploadMs, gpuMs);
-        if (ok) std::cout << "[Serial (staging)] Frame " << frame << " upload(ms)=" << uploadMs << " gpu(ms)=" << gpuMs << std::endl; else std::cout << "[Serial (staging)] Frame " << frame << " FAILED" << std::endl;
-    }
-    double s_t1 = emscripten_get_now();
-    std::cout << "[Serial (staging)] Total time: " << (s_t1 - s_t0) << " ms" << std::endl;
+    run_serial_staging();
+
+    // Steady-state staging belt
+    std::cout << "Running staging-belt benchmark..." << std::endl;
+    run_staging_belt();
 
     // Pipelined writeBuffer
     std::cout << "Running pipelined benchmark (writeBuffer)..." << std::endl;
-    // reset flags
-    bufferA_ready_for_upload.store(false); bufferB_ready_for_upload.store(false); done.store(false);
-    run_pipelined_writeBuffer();
+    bench_pipelined_depths("upload/pipelined-writeBuffer", depth, run_pipelined_writeBuffer<UploadRing>);
 
     // Pipelined staging
     std::cout << "Running pipelined benchmark (staging)..." << std::endl;
-    bufferA_ready_for_upload.store(false); bufferB_ready_for_upload.store(false); done.store(false);
-    run_pipelined_staging();
+    bench_pipelined_depths("upload/pipelined-staging", depth, run_pipelined_staging<UploadRing>);
+
+    // Streaming at one chunk size (--stream sweeps them)
+    std::cout << "Running streaming benchmark (writeBuffer)..." << std::endl;
+    run_stream_sweep(chunkKB > 0 ? chunkKB : STREAM_DEFAULT_CHUNK_KB);
 
     std::cout << "Benchmark complete." << std::endl;
     return 0;
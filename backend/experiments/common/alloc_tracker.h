@@ -0,0 +1,199 @@
+#pragma once
+// Allocation tracking for the C++ experiments.
+//
+// Replaces the global operator new / delete with counting versions, so a
+// benchmark can show that its hot loop is allocation-free, or count what it
+// still allocates. Every block carries a small header holding its size, so
+// live and peak bytes are exact. alloc_footprint_bytes() reports the process
+// view: WASM heap size under Emscripten (it only grows), peak RSS natively.
+// Because this defines the replaceable operators, include it from exactly one
+// translation unit (each experiment is a single file). Cheerp builds keep
+// their own allocator and report zeros.
+//
+//   AllocProbe p = alloc_probe("swarm/pool", 100, "step", [&] { update_boids(dt); });
+//   // [swarm/pool] 0.00 allocs/step, 0 B/step, peak live 1.2 MB, ...
+//
+// Counters are process-wide relaxed atomics; worker-thread allocations count.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/heap.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "bench_harness.h"
+
+#if !defined(__CHEERP__)
+#define ALLOC_TRACKING 1
+#else
+#define ALLOC_TRACKING 0
+#endif
+
+struct AllocCounters {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;         // Total bytes requested
+    uint64_t live_bytes = 0;
+    uint64_t peak_live_bytes = 0;
+};
+
+struct AllocTrackerState {
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> live_bytes{0};
+    std::atomic<uint64_t> peak_live_bytes{0};
+};
+
+// Constant-initialised, so it is ready before any static constructor allocates
+inline AllocTrackerState alloc_tracker_state;
+
+inline AllocCounters alloc_snapshot() {
+    AllocTrackerState& s = alloc_tracker_state;
+    AllocCounters c;
+    c.allocs = s.allocs.load(std::memory_order_relaxed);
+    c.frees = s.frees.load(std::memory_order_relaxed);
+    c.bytes = s.bytes.load(std::memory_order_relaxed);
+    c.live_bytes = s.live_bytes.load(std::memory_order_relaxed);
+    c.peak_live_bytes = s.peak_live_bytes.load(std::memory_order_relaxed);
+    return c;
+}
+
+// Restarts peak tracking from the current live size
+inline void alloc_reset_peak() {
+    AllocTrackerState& s = alloc_tracker_state;
+    s.peak_live_bytes.store(s.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+// WASM heap size (Emscripten) or peak resident set size (native), in bytes
+inline uint64_t alloc_footprint_bytes() {
+#if defined(__EMSCRIPTEN__)
+    return (uint64_t)emscripten_get_heap_size();
+#elif defined(__CHEERP__)
+    return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss;           // Bytes on macOS
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;    // KiB on Linux
+#endif
+#else
+    return 0;
+#endif
+}
+
+// --- Counting Allocator ---
+#if ALLOC_TRACKING
+// [malloc block .. padding | offset back to block | size | user data]
+inline void* alloc_tracked(size_t size, size_t align) {
+    if (align < __STDCPP_DEFAULT_NEW_ALIGNMENT__) align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    const size_t header = 2 * sizeof(size_t);
+    char* raw = (char*)std::malloc(size + header + align);
+    if (!raw) return nullptr;
+    char* user = (char*)(((uintptr_t)raw + header + align) & ~(uintptr_t)(align - 1));
+    ((size_t*)user)[-1] = size;
+    ((size_t*)user)[-2] = (size_t)(user - raw);
+
+    AllocTrackerState& s = alloc_tracker_state;
+    s.allocs.fetch_add(1, std::memory_order_relaxed);
+    s.bytes.fetch_add(size, std::memory_order_relaxed);
+    uint64_t live = s.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = s.peak_live_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !s.peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    return user;
+}
+
+inline void alloc_tracked_free(void* p) {
+    if (!p) return;
+    char* user = (char*)p;
+    size_t size = ((size_t*)user)[-1];
+    size_t offset = ((size_t*)user)[-2];
+    AllocTrackerState& s = alloc_tracker_state;
+    s.frees.fetch_add(1, std::memory_order_relaxed);
+    s.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    std::free(user - offset);
+}
+
+inline void* alloc_tracked_or_throw(size_t size, size_t align) {
+    void* p = alloc_tracked(size, align);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size) { return alloc_tracked_or_throw(size, 0); }
+void* operator new[](size_t size) { return alloc_tracked_or_throw(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return alloc_tracked(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return alloc_tracked(size, 0); }
+void* operator new(size_t size, std::align_val_t align) { return alloc_tracked_or_throw(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align) { return alloc_tracked_or_throw(size, (size_t)align); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return alloc_tracked(size, (size_t)align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return alloc_tracked(size, (size_t)align); }
+
+void operator delete(void* p) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p) noexcept { alloc_tracked_free(p); }
+void operator delete(void* p, size_t) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p, size_t) noexcept { alloc_tracked_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { alloc_tracked_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alloc_tracked_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alloc_tracked_free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alloc_tracked_free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alloc_tracked_free(p); }
+#endif
+
+// --- Probe ---
+struct AllocProbe {
+    int frames = 0;
+    AllocCounters delta;            // allocs / frees / bytes over the probed frames
+    uint64_t peak_live_bytes = 0;   // During the probe
+    uint64_t footprint_bytes = 0;   // After the probe
+    uint64_t footprint_growth = 0;  // During the probe
+
+    double allocs_per_frame() const { return frames ? (double)delta.allocs / frames : 0.0; }
+    double bytes_per_frame() const { return frames ? (double)delta.bytes / frames : 0.0; }
+};
+
+// Runs frame() once untracked (first-use growth), then `frames` more times,
+// and prints per-frame allocation counts plus a `<name>/allocs` RESULT line
+template <typename Fn>
+AllocProbe alloc_probe(const char* name, int frames, const char* unit, Fn&& frame) {
+    frame();
+    alloc_reset_peak();
+    AllocCounters before = alloc_snapshot();
+    uint64_t footprintBefore = alloc_footprint_bytes();
+    for (int i = 0; i < frames; i++) frame();
+    AllocCounters after = alloc_snapshot();
+
+    AllocProbe p;
+    p.frames = frames;
+    p.delta.allocs = after.allocs - before.allocs;
+    p.delta.frees = after.frees - before.frees;
+    p.delta.bytes = after.bytes - before.bytes;
+    p.peak_live_bytes = after.peak_live_bytes;
+    p.footprint_bytes = alloc_footprint_bytes();
+    p.footprint_growth = p.footprint_bytes - footprintBefore;
+
+    std::printf("[%s] %.2f allocs/%s, %.0f B/%s, peak live %.2f MB, footprint %.1f MB (+%.1f MB)%s\n", name,
+                p.allocs_per_frame(), unit, p.bytes_per_frame(), unit, p.peak_live_bytes / 1048576.0,
+                p.footprint_bytes / 1048576.0, p.footprint_growth / 1048576.0, ALLOC_TRACKING ? "" : " (not tracked)");
+    std::printf("RESULT: {\"name\":\"%s/allocs\",\"unit\":\"%s\",\"frames\":%d,\"allocsPerFrame\":%.6g,"
+                "\"freesPerFrame\":%.6g,\"bytesPerFrame\":%.6g,\"peakLiveBytes\":%llu,\"footprintBytes\":%llu,"
+                "\"footprintGrowthBytes\":%llu}\n",
+                bench_json_escape(name).c_str(), unit, frames, p.allocs_per_frame(),
+                frames ? (double)p.delta.frees / frames : 0.0, p.bytes_per_frame(),
+                (unsigned long long)p.peak_live_bytes, (unsigned long long)p.footprint_bytes,
+                (unsigned long long)p.footprint_growth);
+    std::fflush(stdout);
+    return p;
+}
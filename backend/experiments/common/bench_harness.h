@@ -0,0 +1,239 @@
+#pragma once
+// Statistical benchmark harness shared by the C++ experiments and kernels.
+//
+// bench_run() does warmup repetitions, then repeats until the relative margin
+// of error of the mean (95% confidence) drops below a target, or a repetition /
+// time budget runs out. Each result is printed as a human-readable line plus a
+// machine-readable `RESULT: {json}` line for the UI's WasmRunner to parse.
+//
+//   BenchConfig cfg;
+//   BenchReport r = bench_run_timed("swarm/openmp", [&] { update_boids_openmp(dt); }, cfg);
+//   bench_print(r);
+//
+// For repetitions that measure only part of their own work (e.g. CPU encode
+// time of a submit that also waits for the GPU), use bench_run() and return the
+// sample; extra per-repetition metrics go through BenchContext::record().
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#endif
+
+// Milliseconds on a monotonic clock. Emscripten builds (and the native shim)
+// use emscripten_get_now(); Cheerp and plain native builds use steady_clock,
+// which their libc backs with performance.now() / clock_gettime.
+inline double bench_now_ms() {
+#if defined(__EMSCRIPTEN__)
+    return emscripten_get_now();
+#else
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+template <typename Fn>
+double bench_time_ms(Fn&& fn) {
+    double t0 = bench_now_ms();
+    fn();
+    return bench_now_ms() - t0;
+}
+
+struct BenchConfig {
+    int warmup = 3;             // Discarded repetitions before sampling
+    int min_reps = 5;
+    int max_reps = 200;
+    double target_rme = 0.02;   // Stop once the 95% margin of error is within 2% of the mean
+    double max_time_ms = 2000;  // Per benchmark, warmup included
+    double ops_per_rep = 0;     // If > 0, also report ops/sec from the median
+    const char* unit = "ms";
+};
+
+struct BenchStats {
+    int samples = 0;
+    double mean = 0, stddev = 0;
+    double median = 0, p95 = 0, p99 = 0;
+    double mad = 0;             // Median absolute deviation (unscaled)
+    double min = 0, max = 0;
+    double rme = 0;             // Relative margin of error of the mean, 95% confidence
+    double ci_low = 0, ci_high = 0;
+};
+
+// Two-sided 95% Student-t critical values for df = 1..30; 1.96 beyond
+inline double bench_t95(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (df < 1) return 0.0;
+    return df <= 30 ? table[df - 1] : 1.96;
+}
+
+// Linear interpolation between closest ranks; `sorted` must be ascending
+inline double bench_percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    double pos = p * (double)(sorted.size() - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (pos - (double)lo);
+}
+
+inline BenchStats bench_compute_stats(const std::vector<double>& samples) {
+    BenchStats s;
+    s.samples = (int)samples.size();
+    if (samples.empty()) return s;
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    s.min = sorted.front();
+    s.max = sorted.back();
+    s.median = bench_percentile(sorted, 0.50);
+    s.p95 = bench_percentile(sorted, 0.95);
+    s.p99 = bench_percentile(sorted, 0.99);
+
+    double sum = 0;
+    for (double v : samples) sum += v;
+    s.mean = sum / s.samples;
+
+    double sq = 0;
+    for (double v : samples) sq += (v - s.mean) * (v - s.mean);
+    s.stddev = s.samples > 1 ? std::sqrt(sq / (s.samples - 1)) : 0.0;
+
+    std::vector<double> dev(sorted.size());
+    for (size_t i = 0; i < sorted.size(); i++) dev[i] = std::fabs(sorted[i] - s.median);
+    std::sort(dev.begin(), dev.end());
+    s.mad = bench_percentile(dev, 0.50);
+
+    double margin = s.samples > 1 ? bench_t95(s.samples - 1) * s.stddev / std::sqrt((double)s.samples) : 0.0;
+    s.rme = s.mean != 0.0 ? margin / s.mean : 0.0;
+    s.ci_low = s.mean - margin;
+    s.ci_high = s.mean + margin;
+    return s;
+}
+
+// Named secondary series recorded alongside the primary sample
+struct BenchMetric {
+    std::string name;
+    std::vector<double> samples;
+};
+
+class BenchContext {
+public:
+    BenchContext(bool warmup, std::vector<BenchMetric>* sink) : warmup_(warmup), sink_(sink) {}
+
+    bool warmup() const { return warmup_; }
+
+    // Adds a sample to a secondary series (ignored during warmup)
+    void record(const char* metric, double value) {
+        if (warmup_ || !sink_) return;
+        for (auto& m : *sink_) {
+            if (m.name == metric) {
+                m.samples.push_back(value);
+                return;
+            }
+        }
+        sink_->push_back(BenchMetric{metric, {value}});
+    }
+
+private:
+    bool warmup_;
+    std::vector<BenchMetric>* sink_;
+};
+
+struct BenchReport {
+    std::string name;
+    BenchConfig config;
+    BenchStats stats;
+    bool converged = false;
+    std::vector<double> samples;
+    std::vector<BenchMetric> metrics;
+
+    // Stats of a secondary series (empty stats if it was never recorded)
+    BenchStats metric(const char* metric_name) const {
+        for (const auto& m : metrics) {
+            if (m.name == metric_name) return bench_compute_stats(m.samples);
+        }
+        return BenchStats();
+    }
+};
+
+// fn(BenchContext&) runs one repetition and returns its primary sample.
+template <typename Fn>
+BenchReport bench_run(const char* name, Fn&& fn, const BenchConfig& cfg = BenchConfig()) {
+    BenchReport report;
+    report.name = name;
+    report.config = cfg;
+
+    double start = bench_now_ms();
+    for (int i = 0; i < cfg.warmup; i++) {
+        BenchContext ctx(true, nullptr);
+        fn(ctx);
+        if (bench_now_ms() - start > cfg.max_time_ms) break;
+    }
+
+    while ((int)report.samples.size() < cfg.max_reps) {
+        BenchContext ctx(false, &report.metrics);
+        report.samples.push_back(fn(ctx));
+
+        int n = (int)report.samples.size();
+        if (n >= cfg.min_reps) {
+            report.stats = bench_compute_stats(report.samples);
+            if (report.stats.rme <= cfg.target_rme) {
+                report.converged = true;
+                break;
+            }
+        }
+        if (bench_now_ms() - start > cfg.max_time_ms && n >= 2) break;
+    }
+    report.stats = bench_compute_stats(report.samples);
+    report.converged = report.converged || report.stats.rme <= cfg.target_rme;
+    return report;
+}
+
+// Times fn() per repetition
+template <typename Fn>
+BenchReport bench_run_timed(const char* name, Fn&& fn, const BenchConfig& cfg = BenchConfig()) {
+    return bench_run(name, [&fn](BenchContext&) { return bench_time_ms(fn); }, cfg);
+}
+
+inline std::string bench_json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+inline void bench_print_stats(const std::string& name, const char* unit, const BenchStats& s, bool converged, double ops_per_rep) {
+    std::printf("[%s] median %.4f %s (p95 %.4f, p99 %.4f, MAD %.4f, +/-%.1f%%, n=%d%s)\n",
+                name.c_str(), s.median, unit, s.p95, s.p99, s.mad, s.rme * 100.0, s.samples,
+                converged ? "" : ", not converged");
+
+    std::printf("RESULT: {\"name\":\"%s\",\"unit\":\"%s\",\"samples\":%d,\"mean\":%.6g,\"stddev\":%.6g,"
+                "\"median\":%.6g,\"p95\":%.6g,\"p99\":%.6g,\"mad\":%.6g,\"min\":%.6g,\"max\":%.6g,"
+                "\"rme\":%.6g,\"ci95\":[%.6g,%.6g],\"converged\":%s",
+                bench_json_escape(name).c_str(), unit, s.samples, s.mean, s.stddev,
+                s.median, s.p95, s.p99, s.mad, s.min, s.max,
+                s.rme, s.ci_low, s.ci_high, converged ? "true" : "false");
+    if (ops_per_rep > 0 && s.median > 0) {
+        std::printf(",\"opsPerSec\":%.6g", ops_per_rep * 1000.0 / s.median);
+    }
+    std::printf("}\n");
+    std::fflush(stdout);
+}
+
+// Prints the primary series and every secondary metric as "<name>/<metric>"
+inline void bench_print(const BenchReport& r) {
+    bench_print_stats(r.name, r.config.unit, r.stats, r.converged, r.config.ops_per_rep);
+    for (const auto& m : r.metrics) {
+        BenchStats s = bench_compute_stats(m.samples);
+        bench_print_stats(r.name + "/" + m.name, r.config.unit, s, s.rme <= r.config.target_rme, 0.0);
+    }
+}
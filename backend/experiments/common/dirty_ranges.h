@@ -0,0 +1,102 @@
+#pragma once
+// Page-granular dirty tracking for partial GPU buffer uploads.
+//
+// The producer marks the byte ranges it changed; coalesce() turns the dirty
+// pages into a minimal list of byte ranges, merging runs separated by at most
+// `max_gap_pages` clean pages. A larger gap uploads some clean bytes in exchange
+// for fewer writeBuffer / copy calls.
+//
+//   DirtyRanges dirty(bufferBytes);          // 4 KiB pages
+//   dirty.mark(offset, size);
+//   for (const DirtyRange& r : dirty.coalesce(4))
+//       wgpuQueueWriteBuffer(queue, gpuBuffer, r.offset, base + r.offset, r.size);
+//   dirty.clear();
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+struct DirtyRange {
+    uint64_t offset;
+    uint64_t size;
+};
+
+class DirtyRanges {
+public:
+    // `page_bytes` must be a multiple of 4 so ranges stay copy-aligned
+    explicit DirtyRanges(uint64_t size_bytes, uint64_t page_bytes = 4096)
+        : size_(size_bytes), page_(page_bytes),
+          pages_((size_bytes + page_bytes - 1) / page_bytes),
+          words_((pages_ + 63) / 64, 0) {}
+
+    uint64_t size() const { return size_; }
+    uint64_t page_size() const { return page_; }
+    uint64_t page_count() const { return pages_; }
+
+    void mark(uint64_t offset, uint64_t size) {
+        if (size == 0 || offset >= size_) return;
+        uint64_t first = offset / page_;
+        uint64_t last = (std::min(offset + size, size_) - 1) / page_;
+        for (uint64_t p = first; p <= last; p++) words_[p / 64] |= uint64_t(1) << (p % 64);
+    }
+
+    void mark_page(uint64_t page) {
+        if (page < pages_) words_[page / 64] |= uint64_t(1) << (page % 64);
+    }
+
+    void mark_all() { mark(0, size_); }
+
+    void clear() {
+        for (auto& w : words_) w = 0;
+    }
+
+    uint64_t dirty_pages() const {
+        uint64_t n = 0;
+        for (uint64_t w : words_) n += (uint64_t)__builtin_popcountll(w);
+        return n;
+    }
+
+    // Dirty byte ranges in ascending order; valid until the next call
+    const std::vector<DirtyRange>& coalesce(uint64_t max_gap_pages) {
+        ranges_.clear();
+        coalesce_into(ranges_, max_gap_pages);
+        return ranges_;
+    }
+
+    // Same ranges appended to a caller-owned container, e.g. frame scratch
+    // from common/frame_arena.h
+    template <typename Vec>
+    void coalesce_into(Vec& out, uint64_t max_gap_pages) const {
+        uint64_t run_start = 0, run_end = 0; // Pages, [start, end)
+        bool open = false;
+        for (size_t w = 0; w < words_.size(); w++) {
+            uint64_t bits = words_[w];
+            while (bits) {
+                uint64_t page = w * 64 + (uint64_t)__builtin_ctzll(bits);
+                bits &= bits - 1;
+                if (open && page - run_end <= max_gap_pages) {
+                    run_end = page + 1;
+                    continue;
+                }
+                if (open) out.push_back(range(run_start, run_end));
+                run_start = page;
+                run_end = page + 1;
+                open = true;
+            }
+        }
+        if (open) out.push_back(range(run_start, run_end));
+    }
+
+private:
+    DirtyRange range(uint64_t first_page, uint64_t end_page) const {
+        uint64_t offset = first_page * page_;
+        uint64_t end = std::min(end_page * page_, size_);
+        return DirtyRange{offset, end - offset};
+    }
+
+    uint64_t size_;
+    uint64_t page_;
+    uint64_t pages_;
+    std::vector<uint64_t> words_;   // One bit per page
+    std::vector<DirtyRange> ranges_;
+};
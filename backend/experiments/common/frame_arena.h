@@ -0,0 +1,109 @@
+#pragma once
+// Per-frame bump allocator for frame-scoped scratch.
+//
+// allocate() bumps a pointer through one pre-reserved block, and reset() at the
+// end of the frame releases everything at once. No per-object frees, and once
+// warm, no heap traffic. If a frame outgrows the block, the extra requests go
+// to overflow blocks from the heap. The next reset() then regrows the main
+// block to that frame's high-water mark, so steady-state frames fit again.
+// Objects must be trivially destructible; nothing runs destructors.
+//
+//   FrameArena arena(64 << 10);
+//   std::vector<DirtyRange, ArenaAllocator<DirtyRange>> ranges{ArenaAllocator<DirtyRange>(arena)};
+//   ... fill and use ranges for this frame ...
+//   arena.reset();   // After the frame's last use (ranges' storage goes with it)
+//
+// Not thread-safe: use one arena per thread.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity = 1 << 20) { reserve(capacity); }
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // `align` must be a power of two
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        uintptr_t base = (uintptr_t)block_.get();
+        uintptr_t p = (base + used_ + align - 1) & ~(uintptr_t)(align - 1);
+        if (p + size <= base + capacity_) {
+            used_ = (size_t)(p - base) + size;
+            frame_bytes_ = std::max(frame_bytes_, used_ + overflow_bytes_);
+            return (void*)p;
+        }
+        // Overflow: served from the heap until the next reset()
+        overflow_bytes_ += size + align;
+        frame_bytes_ = std::max(frame_bytes_, used_ + overflow_bytes_);
+        overflows_++;
+        overflow_.emplace_back(new unsigned char[size + align]);
+        uintptr_t o = ((uintptr_t)overflow_.back().get() + align - 1) & ~(uintptr_t)(align - 1);
+        return (void*)o;
+    }
+
+    // Uninitialised storage for n objects of a trivially destructible T
+    template <typename T>
+    T* alloc_array(size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "FrameArena never runs destructors");
+        return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // Ends the frame: every pointer handed out since the last reset() dies
+    void reset() {
+        if (!overflow_.empty()) {
+            overflow_.clear();
+            reserve(frame_bytes_);
+        }
+        high_water_ = std::max(high_water_, frame_bytes_);
+        used_ = 0;
+        overflow_bytes_ = 0;
+        frame_bytes_ = 0;
+    }
+
+    size_t used() const { return used_; }
+    size_t capacity() const { return capacity_; }
+    size_t high_water() const { return std::max(high_water_, frame_bytes_); } // Largest frame, bytes
+    uint64_t overflows() const { return overflows_; }                         // Requests served from the heap
+
+private:
+    void reserve(size_t capacity) {
+        capacity_ = std::max<size_t>(capacity, 64);
+        block_.reset(new unsigned char[capacity_]);
+    }
+
+    std::unique_ptr<unsigned char[]> block_;
+    size_t capacity_ = 0;
+    size_t used_ = 0;
+    size_t overflow_bytes_ = 0;
+    size_t frame_bytes_ = 0;
+    size_t high_water_ = 0;
+    uint64_t overflows_ = 0;
+    std::vector<std::unique_ptr<unsigned char[]>> overflow_;
+};
+
+// STL allocator over a FrameArena; deallocate() is a no-op, so growth inside
+// a frame leaves the old storage in place until reset()
+template <typename T>
+struct ArenaAllocator {
+    typedef T value_type;
+
+    FrameArena* arena;
+
+    explicit ArenaAllocator(FrameArena& a) : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+};
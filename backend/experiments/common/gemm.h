@@ -0,0 +1,244 @@
+#pragma once
+// Single-precision GEMM, C = A * B on row-major matrices, for the CPU
+// benchmarks.
+//
+// gemm_naive() is the textbook i-j-k loop, kept as the reference. gemm_blocked()
+// follows the GotoBLAS / BLIS structure: B is packed in KC x NC blocks (sized
+// for L2/L3), A in MC x KC blocks (L2), and a GEMM_MR x GEMM_NR register-tile
+// micro-kernel streams both packed panels through L1. The micro-kernel uses
+// 4-wide vector extensions when the target has SIMD (wasm SIMD128, SSE,
+// NEON); otherwise it uses plain scalar code. With `parallel`, the MC row
+// blocks are spread over the shared thread pool. Cheerp builds run single-
+// threaded.
+//
+//   GemmMatrix a(n, n), b(n, n), c(n, n);
+//   gemm_fill(a, 1); gemm_fill(b, 2);
+//   gemm_blocked(a, b, c, true);
+//   double sum = gemm_checksum(c);
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if !defined(__CHEERP__)
+#include "thread_pool.h"
+#define GEMM_THREADS 1
+#else
+#define GEMM_THREADS 0
+#endif
+
+#if defined(__wasm_simd128__) || defined(__SSE2__) || defined(__ARM_NEON)
+#define GEMM_SIMD 1
+typedef float gemm_f4 __attribute__((vector_size(16)));
+#else
+#define GEMM_SIMD 0
+#endif
+
+// Register tile (4 rows x two 4-wide vectors) and cache blocks
+const int GEMM_MR = 4;
+const int GEMM_NR = 8;
+const int GEMM_MC = 128;   // A block: MC x KC floats = 128 KB
+const int GEMM_KC = 256;
+const int GEMM_NC = 1024;  // B block: KC x NC floats = 1 MB
+
+// Row-major matrix on a 64-byte aligned heap buffer
+class GemmMatrix {
+public:
+    GemmMatrix(int rows, int cols)
+        : rows_(rows), cols_(cols), storage_((size_t)rows * cols + 16, 0.0f) {
+        uintptr_t p = (uintptr_t)storage_.data();
+        data_ = (float*)((p + 63) & ~(uintptr_t)63);
+    }
+    GemmMatrix(const GemmMatrix&) = delete;
+    GemmMatrix& operator=(const GemmMatrix&) = delete;
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    float* data() { return data_; }
+    const float* data() const { return data_; }
+    float& at(int i, int j) { return data_[(size_t)i * cols_ + j]; }
+    float at(int i, int j) const { return data_[(size_t)i * cols_ + j]; }
+
+private:
+    int rows_, cols_;
+    std::vector<float> storage_;
+    float* data_;
+};
+
+// Deterministic values in [-1, 1)
+inline void gemm_fill(GemmMatrix& m, uint32_t seed) {
+    uint32_t state = seed * 2654435761u + 1u;
+    size_t n = (size_t)m.rows() * m.cols();
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1664525u + 1013904223u;
+        m.data()[i] = (float)(state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+}
+
+inline double gemm_checksum(const GemmMatrix& m) {
+    double sum = 0.0;
+    size_t n = (size_t)m.rows() * m.cols();
+    for (size_t i = 0; i < n; i++) sum += m.data()[i];
+    return sum;
+}
+
+inline double gemm_max_abs_diff(const GemmMatrix& x, const GemmMatrix& y) {
+    double d = 0.0;
+    size_t n = (size_t)x.rows() * x.cols();
+    for (size_t i = 0; i < n; i++) d = std::max(d, (double)std::fabs(x.data()[i] - y.data()[i]));
+    return d;
+}
+
+// Floating-point operations in one C = A * B
+inline double gemm_flops(const GemmMatrix& a, const GemmMatrix& b) {
+    return 2.0 * a.rows() * a.cols() * b.cols();
+}
+
+// --- Reference ---
+inline void gemm_naive(const GemmMatrix& a, const GemmMatrix& b, GemmMatrix& c) {
+    int m = a.rows(), k = a.cols(), n = b.cols();
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            float sum = 0.0f;
+            for (int p = 0; p < k; p++) sum += a.at(i, p) * b.at(p, j);
+            c.at(i, j) = sum;
+        }
+    }
+}
+
+// --- Packing ---
+// A[ic:ic+mc, pc:pc+kc] as MR-row panels, k-major inside each panel; rows
+// past the edge are zero so the micro-kernel never branches
+inline void gemm_pack_a(const GemmMatrix& a, int ic, int pc, int mc, int kc, float* out) {
+    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+        for (int p = 0; p < kc; p++) {
+            for (int r = 0; r < GEMM_MR; r++) {
+                *out++ = ir + r < mc ? a.at(ic + ir + r, pc + p) : 0.0f;
+            }
+        }
+    }
+}
+
+// B[pc:pc+kc, jc:jc+nc] as NR-column panels, k-major inside each panel
+inline void gemm_pack_b(const GemmMatrix& b, int pc, int jc, int kc, int nc, float* out) {
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+        int cols = std::min(GEMM_NR, nc - jr);
+        for (int p = 0; p < kc; p++) {
+            const float* row = &b.data()[(size_t)(pc + p) * b.cols() + jc + jr];
+            for (int j = 0; j < GEMM_NR; j++) *out++ = j < cols ? row[j] : 0.0f;
+        }
+    }
+}
+
+// --- Micro-kernel ---
+// C[0:mr, 0:nr] += packed A panel * packed B panel over kc
+inline void gemm_micro_kernel(int kc, const float* pa, const float* pb, float* c, int ldc, int mr, int nr) {
+    float tile[GEMM_MR][GEMM_NR];
+#if GEMM_SIMD
+    gemm_f4 acc[GEMM_MR][2] = {};
+    for (int p = 0; p < kc; p++) {
+        gemm_f4 b0, b1;
+        std::memcpy(&b0, pb, sizeof(b0));
+        std::memcpy(&b1, pb + 4, sizeof(b1));
+        for (int r = 0; r < GEMM_MR; r++) {
+            acc[r][0] += b0 * pa[r];
+            acc[r][1] += b1 * pa[r];
+        }
+        pa += GEMM_MR;
+        pb += GEMM_NR;
+    }
+    if (mr == GEMM_MR && nr == GEMM_NR) {
+        for (int r = 0; r < GEMM_MR; r++) {
+            gemm_f4 c0, c1;
+            std::memcpy(&c0, c + r * ldc, sizeof(c0));
+            std::memcpy(&c1, c + r * ldc + 4, sizeof(c1));
+            c0 += acc[r][0];
+            c1 += acc[r][1];
+            std::memcpy(c + r * ldc, &c0, sizeof(c0));
+            std::memcpy(c + r * ldc + 4, &c1, sizeof(c1));
+        }
+        return;
+    }
+    std::memcpy(tile, acc, sizeof(tile));
+#else
+    for (int r = 0; r < GEMM_MR; r++) {
+        for (int j = 0; j < GEMM_NR; j++) tile[r][j] = 0.0f;
+    }
+    for (int p = 0; p < kc; p++) {
+        for (int r = 0; r < GEMM_MR; r++) {
+            for (int j = 0; j < GEMM_NR; j++) tile[r][j] += pa[r] * pb[j];
+        }
+        pa += GEMM_MR;
+        pb += GEMM_NR;
+    }
+#endif
+    // Edge tile (always taken by the scalar path)
+    for (int r = 0; r < mr; r++) {
+        for (int j = 0; j < nr; j++) c[r * ldc + j] += tile[r][j];
+    }
+}
+
+// --- Blocked GEMM ---
+// One MC x NC block of C: packs its slice of A, then sweeps the register tiles
+inline void gemm_block(const GemmMatrix& a, GemmMatrix& c, const float* packedB,
+                       int ic, int pc, int jc, int mc, int kc, int nc, float* packA) {
+    gemm_pack_a(a, ic, pc, mc, kc, packA);
+    int ldc = c.cols();
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+        const float* pb = packedB + (size_t)(jr / GEMM_NR) * kc * GEMM_NR;
+        for (int ir = 0; ir < mc; ir += GEMM_MR) {
+            const float* pa = packA + (size_t)(ir / GEMM_MR) * kc * GEMM_MR;
+            float* cTile = &c.data()[(size_t)(ic + ir) * ldc + jc + jr];
+            gemm_micro_kernel(kc, pa, pb, cTile, ldc, std::min(GEMM_MR, mc - ir), std::min(GEMM_NR, nc - jr));
+        }
+    }
+}
+
+inline void gemm_blocked(const GemmMatrix& a, const GemmMatrix& b, GemmMatrix& c, bool parallel = false) {
+    int m = a.rows(), k = a.cols(), n = b.cols();
+    std::fill(c.data(), c.data() + (size_t)m * n, 0.0f);
+    const int mcPadded = (GEMM_MC + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+    const int ncPadded = (GEMM_NC + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    const size_t packASize = (size_t)mcPadded * GEMM_KC;
+    int mBlocks = (m + GEMM_MC - 1) / GEMM_MC;
+    // The row blocks are split into at most one slice per pool thread; each
+    // slice has its own A pack buffer, reused for every (jc, pc) block
+    size_t slices = 1;
+#if GEMM_THREADS
+    if (parallel && mBlocks > 1) slices = std::min<size_t>(mBlocks, ThreadPool::instance().size());
+#else
+    (void)parallel;
+    (void)mBlocks;
+#endif
+    std::vector<float> packB((size_t)GEMM_KC * ncPadded);
+    std::vector<float> packA(packASize * slices);
+
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        int nc = std::min(GEMM_NC, n - jc);
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            int kc = std::min(GEMM_KC, k - pc);
+            gemm_pack_b(b, pc, jc, kc, nc, packB.data());
+            const float* packedB = packB.data();
+#if GEMM_THREADS
+            if (slices > 1) {
+                ThreadPool::instance().parallel_for(0, slices, 1, [&](size_t s0, size_t s1) {
+                    for (size_t s = s0; s < s1; s++) {
+                        float* localA = packA.data() + s * packASize;
+                        for (size_t blk = s * mBlocks / slices; blk < (s + 1) * mBlocks / slices; blk++) {
+                            int ic = (int)blk * GEMM_MC;
+                            gemm_block(a, c, packedB, ic, pc, jc, std::min(GEMM_MC, m - ic), kc, nc, localA);
+                        }
+                    }
+                });
+                continue;
+            }
+#endif
+            for (int ic = 0; ic < m; ic += GEMM_MC) {
+                gemm_block(a, c, packedB, ic, pc, jc, std::min(GEMM_MC, m - ic), kc, nc, packA.data());
+            }
+        }
+    }
+}
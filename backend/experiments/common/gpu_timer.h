@@ -0,0 +1,276 @@
+#pragma once
+// GPU-side timing for the WebGPU experiments.
+//
+// With the timestamp-query feature, a two-entry QuerySet records GPU
+// timestamps at the start and end of the timed work, which are resolved into a
+// buffer and read back, so the duration excludes queue latency and the
+// polling interval. Without it, collect() falls back to timing an
+// OnSubmittedWorkDone callback, which does include them.
+//
+//   gpu_timer_request_features(adapter, deviceDesc);   // Before RequestDevice
+//   timer.init(device, queue);
+//
+//   // Time one compute pass
+//   passDesc.timestampWrites = timer.pass_writes();
+//   ... record the pass ...
+//   timer.resolve(encoder);
+//   wgpuQueueSubmit(...);
+//   GpuTiming t = timer.collect();
+//
+//   // Time a span across several submits
+//   timer.submit_begin();
+//   ... submit work ...
+//   timer.submit_end();
+//   GpuTiming t = timer.collect();
+//
+// A collect() that times out leaves its readback map (or queue callback)
+// pending. The next resolve() unmaps the buffer if that map has landed since,
+// or swaps in a fresh readback buffer if it has not, so one slow frame does
+// not break the frames after it.
+//
+// Browsers may quantise timestamps (Chrome rounds to 100 us unless
+// --enable-webgpu-developer-features is set).
+
+#include <emscripten/emscripten.h>
+#include <webgpu/webgpu.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "trace.h"
+
+struct GpuTiming {
+    bool ok = false;            // False on timeout, a failed map / work-done callback, or an invalid timestamp pair
+    double ms = 0.0;
+    bool from_timestamps = false;
+};
+
+// Adds timestamp-query to the device request when the adapter supports it.
+// `desc` may be passed straight to wgpuAdapterRequestDevice.
+inline void gpu_timer_request_features(WGPUAdapter adapter, WGPUDeviceDescriptor& desc) {
+    static const WGPUFeatureName kFeatures[] = { WGPUFeatureName_TimestampQuery };
+    if (wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery)) {
+        desc.requiredFeatureCount = 1;
+        desc.requiredFeatures = kFeatures;
+    }
+}
+
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    ~GpuTimer() { release(); }
+
+    // Creates the query set and buffers if the device has timestamp-query
+    void init(WGPUDevice device, WGPUQueue queue) {
+        release();
+        device_ = device;
+        queue_ = queue;
+        if (!wgpuDeviceHasFeature(device, WGPUFeatureName_TimestampQuery)) return;
+
+        WGPUQuerySetDescriptor qsDesc = {};
+        qsDesc.type = WGPUQueryType_Timestamp;
+        qsDesc.count = 2;
+        query_set_ = wgpuDeviceCreateQuerySet(device, &qsDesc);
+
+        WGPUBufferDescriptor resolveDesc = {};
+        resolveDesc.size = kResolveBytes;
+        resolveDesc.usage = WGPUBufferUsage_QueryResolve | WGPUBufferUsage_CopySrc;
+        resolve_buffer_ = wgpuDeviceCreateBuffer(device, &resolveDesc);
+
+        readback_buffer_ = create_readback_buffer();
+
+        writes_.querySet = query_set_;
+        writes_.beginningOfPassWriteIndex = 0;
+        writes_.endOfPassWriteIndex = 1;
+    }
+
+    void release() {
+        if (late_map_) late_map_->drop();
+        late_map_ = nullptr;
+        if (query_set_) wgpuQuerySetRelease(query_set_);
+        if (resolve_buffer_) wgpuBufferRelease(resolve_buffer_);
+        if (readback_buffer_) wgpuBufferRelease(readback_buffer_);
+        query_set_ = nullptr;
+        resolve_buffer_ = nullptr;
+        readback_buffer_ = nullptr;
+    }
+
+    bool has_timestamps() const { return query_set_ != nullptr; }
+    const char* source() const { return has_timestamps() ? "timestamp-query" : "queue-callback"; }
+
+    // Number of collect() calls that gave up waiting
+    int timeouts() const { return timeouts_; }
+
+    // Timestamp writes that time a single compute pass; nullptr in fallback mode
+    const WGPUComputePassTimestampWrites* pass_writes() const {
+        return has_timestamps() ? &writes_ : nullptr;
+    }
+
+    // Empty passes that mark the start / end of a span within one encoder
+    void mark_begin(WGPUCommandEncoder encoder) { write_marker(encoder, 0, WGPU_QUERY_SET_INDEX_UNDEFINED); }
+    void mark_end(WGPUCommandEncoder encoder) { write_marker(encoder, WGPU_QUERY_SET_INDEX_UNDEFINED, 1); }
+
+    // Copies both timestamps towards the readback buffer; record after the
+    // timed work, in the same or a later encoder
+    void resolve(WGPUCommandEncoder encoder) {
+        if (!has_timestamps()) return;
+        settle_late_map();
+        wgpuCommandEncoderResolveQuerySet(encoder, query_set_, 0, 2, resolve_buffer_, 0);
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, resolve_buffer_, 0, readback_buffer_, 0, kResolveBytes);
+    }
+
+    // Span over several submits: each call submits its own small command buffer
+    void submit_begin() {
+        if (!has_timestamps()) return;
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device_, nullptr);
+        mark_begin(encoder);
+        submit(encoder);
+    }
+
+    void submit_end() {
+        if (!has_timestamps()) return;
+        WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device_, nullptr);
+        mark_end(encoder);
+        resolve(encoder);
+        submit(encoder);
+    }
+
+    // Call once the timed work is submitted; blocks (yielding) until the
+    // duration is known or `timeout_ms` passes
+    GpuTiming collect(double timeout_ms = 2000.0) {
+        TRACE_SCOPE("gpu-wait");
+        GpuTiming timing = has_timestamps() ? read_timestamps(timeout_ms) : wait_for_queue(timeout_ms);
+        if (!timing.ok) timeouts_++;
+        return timing;
+    }
+
+private:
+    static constexpr uint64_t kResolveBytes = 2 * sizeof(uint64_t);
+
+    // State shared by a wait and its callback; whichever side finishes with it
+    // last frees it, so a wait that times out can walk away
+    struct GpuWait {
+        std::atomic<int> refs{2};
+        std::atomic<bool> done{false};
+        bool ok = false;
+        double end_ms = 0.0;
+
+        void drop() {
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+        }
+    };
+
+    // Yields until the callback has fired or `deadline` passes
+    static bool wait_until(const GpuWait* w, double deadline) {
+        while (!w->done.load(std::memory_order_acquire) && emscripten_get_now() < deadline) emscripten_sleep(1);
+        return w->done.load(std::memory_order_acquire);
+    }
+
+    WGPUBuffer create_readback_buffer() {
+        WGPUBufferDescriptor desc = {};
+        desc.size = kResolveBytes;
+        desc.usage = WGPUBufferUsage_MapRead | WGPUBufferUsage_CopyDst;
+        return wgpuDeviceCreateBuffer(device_, &desc);
+    }
+
+    // Makes the readback buffer copyable again after a timed-out collect()
+    void settle_late_map() {
+        if (!late_map_) return;
+        if (late_map_->done.load(std::memory_order_acquire)) {
+            if (late_map_->ok) wgpuBufferUnmap(readback_buffer_);
+        } else {
+            // Still pending: leave the map to the old buffer and stop using it
+            wgpuBufferRelease(readback_buffer_);
+            readback_buffer_ = create_readback_buffer();
+        }
+        late_map_->drop();
+        late_map_ = nullptr;
+    }
+
+    void write_marker(WGPUCommandEncoder encoder, uint32_t begin, uint32_t end) {
+        if (!has_timestamps()) return;
+        WGPUComputePassTimestampWrites writes = {};
+        writes.querySet = query_set_;
+        writes.beginningOfPassWriteIndex = begin;
+        writes.endOfPassWriteIndex = end;
+        WGPUComputePassDescriptor desc = {};
+        desc.timestampWrites = &writes;
+        WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &desc);
+        wgpuComputePassEncoderEnd(pass);
+        wgpuComputePassEncoderRelease(pass);
+    }
+
+    void submit(WGPUCommandEncoder encoder) {
+        WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+        wgpuQueueSubmit(queue_, 1, &commands);
+        wgpuCommandBufferRelease(commands);
+        wgpuCommandEncoderRelease(encoder);
+    }
+
+    GpuTiming read_timestamps(double timeout_ms) {
+        GpuTiming timing;
+        timing.from_timestamps = true;
+        if (late_map_) {
+            // No resolve() since the timeout, so nothing new to read
+            settle_late_map();
+            return timing;
+        }
+        GpuWait* w = new GpuWait();
+        wgpuBufferMapAsync(readback_buffer_, WGPUMapMode_Read, 0, kResolveBytes,
+            [](WGPUBufferMapAsyncStatus status, void* userdata) {
+                GpuWait* d = (GpuWait*)userdata;
+                d->ok = status == WGPUBufferMapAsyncStatus_Success;
+                d->done.store(true, std::memory_order_release);
+                d->drop();
+            }, w);
+
+        if (!wait_until(w, emscripten_get_now() + timeout_ms)) {
+            late_map_ = w; // Settled by the next resolve()
+            return timing;
+        }
+        bool mapped = w->ok;
+        w->drop();
+        if (!mapped) return timing;
+
+        uint64_t ns[2];
+        std::memcpy(ns, wgpuBufferGetConstMappedRange(readback_buffer_, 0, kResolveBytes), sizeof(ns));
+        wgpuBufferUnmap(readback_buffer_);
+        if (ns[1] < ns[0]) return timing;
+        timing.ok = true;
+        timing.ms = (double)(ns[1] - ns[0]) / 1e6;
+        return timing;
+    }
+
+    // Fallback: time from now until the queue reports the submitted work done
+    GpuTiming wait_for_queue(double timeout_ms) {
+        double start = emscripten_get_now();
+        GpuWait* w = new GpuWait();
+        wgpuQueueOnSubmittedWorkDone(queue_, [](WGPUQueueWorkDoneStatus status, void* userdata) {
+            GpuWait* d = (GpuWait*)userdata;
+            d->end_ms = emscripten_get_now();
+            d->ok = status == WGPUQueueWorkDoneStatus_Success;
+            d->done.store(true, std::memory_order_release);
+            d->drop();
+        }, w);
+
+        GpuTiming timing;
+        if (wait_until(w, start + timeout_ms) && w->ok) {
+            timing.ok = true;
+            timing.ms = w->end_ms - start;
+        }
+        w->drop(); // A late callback frees it instead
+        return timing;
+    }
+
+    WGPUDevice device_ = nullptr;
+    WGPUQueue queue_ = nullptr;
+    WGPUQuerySet query_set_ = nullptr;
+    WGPUBuffer resolve_buffer_ = nullptr;
+    WGPUBuffer readback_buffer_ = nullptr;
+    WGPUComputePassTimestampWrites writes_ = {};
+    GpuWait* late_map_ = nullptr; // Readback map left pending by a timed-out collect()
+    int timeouts_ = 0;
+};
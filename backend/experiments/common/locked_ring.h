@@ -0,0 +1,123 @@
+#pragma once
+// Bounded producer / consumer ring guarded by one mutex and two condition
+// variables: the handoff the upload pipeline used before SpscRing.
+//
+// Same interface and stats as SpscRing, so the pipelined benchmarks can run
+// either one. It is kept as the baseline for measuring the lock-free ring:
+// its mutex and condvars are common/sync_stats.h wrappers named
+// "<name>/mtx", "<name>/cv_upload" (frame ready, wakes the consumer) and
+// "<name>/cv_compute" (slot free, wakes the producer). The summary table then
+// shows how long each side spent acquiring the lock, how long it slept, and
+// how long a notify took to wake it: the costs the lock-free ring removes.
+//
+//   LockedRing<std::vector<float>> ring(depth, "upload/locked");
+//   // Same producer / consumer loop as SpscRing
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "spsc_ring.h"
+#include "sync_stats.h"
+#include "trace.h"
+
+template <typename T>
+class LockedRing {
+public:
+    LockedRing(size_t depth, const std::string& name)
+        : slots_(depth ? depth : 1), mtx_(name + "/mtx"), cv_upload_(name + "/cv_upload"),
+          cv_compute_(name + "/cv_compute") {}
+
+    LockedRing(const LockedRing&) = delete;
+    LockedRing& operator=(const LockedRing&) = delete;
+
+    size_t depth() const { return slots_.size(); }
+
+    // Direct slot access for setup (e.g. sizing buffers); not while running
+    T& slot(size_t i) { return slots_[i]; }
+
+    // Rewinds the counters; only while neither side is running
+    void reset() {
+        std::lock_guard<InstrumentedMutex> lock(mtx_);
+        head_ = tail_ = 0;
+        closed_ = false;
+        stats_ = SpscRingStats();
+    }
+
+    // --- Producer ---
+    // Next free slot, waiting while all `depth` slots are in flight
+    T& acquire_write() {
+        std::unique_lock<InstrumentedMutex> lock(mtx_);
+        if (head_ - tail_ >= slots_.size()) {
+            TRACE_SCOPE("ring-full");
+            auto t0 = std::chrono::steady_clock::now();
+            stats_.producer_stalls++;
+            cv_compute_.wait(lock, [this] { return head_ - tail_ < slots_.size(); });
+            stats_.producer_stall_ms += elapsed_ms(t0);
+        }
+        return slots_[head_ % slots_.size()];
+    }
+
+    // Hands the slot from acquire_write() to the consumer
+    void publish() {
+        {
+            std::lock_guard<InstrumentedMutex> lock(mtx_);
+            head_++;
+        }
+        cv_upload_.notify_one();
+    }
+
+    // No more slots will be published; the consumer drains the rest
+    void close() {
+        {
+            std::lock_guard<InstrumentedMutex> lock(mtx_);
+            closed_ = true;
+        }
+        cv_upload_.notify_all();
+    }
+
+    // --- Consumer ---
+    // Oldest published slot, waiting while the ring is empty; nullptr once
+    // the producer has closed the ring and everything has been drained
+    T* acquire_read() {
+        std::unique_lock<InstrumentedMutex> lock(mtx_);
+        if (tail_ == head_ && !closed_) {
+            TRACE_SCOPE("ring-empty");
+            auto t0 = std::chrono::steady_clock::now();
+            stats_.consumer_starves++;
+            cv_upload_.wait(lock, [this] { return tail_ != head_ || closed_; });
+            stats_.consumer_starve_ms += elapsed_ms(t0);
+        }
+        if (tail_ == head_) return nullptr;
+        return &slots_[tail_ % slots_.size()];
+    }
+
+    // Returns the slot from acquire_read() to the producer
+    void release() {
+        {
+            std::lock_guard<InstrumentedMutex> lock(mtx_);
+            tail_++;
+        }
+        cv_compute_.notify_one();
+    }
+
+    // Read once both sides have finished (e.g. after joining the consumer)
+    SpscRingStats stats() const { return stats_; }
+
+private:
+    static double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    std::vector<T> slots_;
+    InstrumentedMutex mtx_;             // Guards everything below
+    InstrumentedCondVar cv_upload_;     // A frame was published (or the ring closed)
+    InstrumentedCondVar cv_compute_;    // A slot was released
+    uint64_t head_ = 0;
+    uint64_t tail_ = 0;
+    bool closed_ = false;
+    SpscRingStats stats_;
+};
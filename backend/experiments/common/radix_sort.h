@@ -0,0 +1,83 @@
+#pragma once
+// Parallel LSD radix sort of (uint32 key, uint32 value) pairs on the shared
+// thread pool.
+//
+// Each 8-bit pass splits the input into fixed blocks. It builds per-block
+// digit histograms in parallel, prefix-sums them serially (digit-major, then
+// block order), and scatters every block in parallel into its own
+// precomputed ranges. The sort is stable, so the output is fully determined
+// by the input and does not depend on the thread count. A pass is skipped when
+// every key has the same digit, so keys that use only their low bits cost fewer
+// passes.
+//
+//   std::vector<uint32_t> keys, vals, tmpKeys, tmpVals, offsets;
+//   radix_sort_pairs(keys, vals, tmpKeys, tmpVals, offsets);  // keys ascending, vals follow
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.h"
+
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+const size_t RADIX_MIN_BLOCK = 4096; // Below this per block, histogram overhead dominates
+
+// `tmpKeys` / `tmpVals` / `offsets` are caller-owned scratch (resized as
+// needed), so repeated sorts do not allocate once warm; `offsets` holds the
+// per-block digit table that every pool worker reads. `key_bits` limits the
+// passes to the low bits that can be non-zero.
+inline void radix_sort_pairs(std::vector<uint32_t>& keys, std::vector<uint32_t>& vals,
+                             std::vector<uint32_t>& tmpKeys, std::vector<uint32_t>& tmpVals,
+                             std::vector<uint32_t>& offsets, int key_bits = 32,
+                             ThreadPool& pool = ThreadPool::instance()) {
+    const size_t n = keys.size();
+    if (n < 2) return;
+    tmpKeys.resize(n);
+    tmpVals.resize(n);
+
+    const size_t blocks = std::max<size_t>(1, std::min<size_t>(pool.size() * 4, n / RADIX_MIN_BLOCK));
+    offsets.resize(blocks * RADIX_BUCKETS); // [block][digit]
+    auto block_begin = [n, blocks](size_t b) { return n * b / blocks; };
+
+    for (int shift = 0; shift < key_bits; shift += RADIX_BITS) {
+        std::fill(offsets.begin(), offsets.end(), 0u);
+        pool.parallel_for(0, blocks, 1, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++) {
+                uint32_t* hist = &offsets[b * RADIX_BUCKETS];
+                for (size_t i = block_begin(b); i < block_begin(b + 1); i++) hist[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            }
+        });
+
+        // Exclusive prefix over (digit, block); a digit holding every key
+        // means this pass would be the identity
+        uint32_t sum = 0;
+        bool trivial = false;
+        for (int d = 0; d < RADIX_BUCKETS; d++) {
+            uint32_t digitTotal = 0;
+            for (size_t b = 0; b < blocks; b++) {
+                uint32_t count = offsets[b * RADIX_BUCKETS + d];
+                offsets[b * RADIX_BUCKETS + d] = sum;
+                sum += count;
+                digitTotal += count;
+            }
+            if (digitTotal == n) trivial = true;
+        }
+        if (trivial) continue;
+
+        pool.parallel_for(0, blocks, 1, [&](size_t b0, size_t b1) {
+            for (size_t b = b0; b < b1; b++) {
+                uint32_t* cursor = &offsets[b * RADIX_BUCKETS];
+                for (size_t i = block_begin(b); i < block_begin(b + 1); i++) {
+                    uint32_t dst = cursor[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                    tmpKeys[dst] = keys[i];
+                    tmpVals[dst] = vals[i];
+                }
+            }
+        });
+        keys.swap(tmpKeys);
+        vals.swap(tmpVals);
+    }
+}
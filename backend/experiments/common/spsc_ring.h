@@ -0,0 +1,152 @@
+#pragma once
+// Bounded single-producer / single-consumer ring of reusable slots.
+//
+// `head_` counts published slots and `tail_` counts released ones. Each side
+// writes only its own counter (release) and reads the other's (acquire), so
+// the fast path takes no lock. A full or empty ring is waited out by spinning
+// briefly, then yielding. Time spent waiting is counted: producer stalls mean
+// the consumer is the bottleneck, consumer starves mean the producer is.
+//
+//   SpscRing<std::vector<float>> ring(depth);
+//   // Producer                          // Consumer
+//   T& s = ring.acquire_write();         while (T* s = ring.acquire_read()) {
+//   ... fill s ...                           ... drain *s ...
+//   ring.publish();                          ring.release();
+//   ...                                  }
+//   ring.close();
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "trace.h"
+
+struct SpscRingStats {
+    uint64_t producer_stalls = 0;   // acquire_write() calls that found the ring full
+    uint64_t consumer_starves = 0;  // acquire_read() calls that found it empty
+    double producer_stall_ms = 0;
+    double consumer_starve_ms = 0;
+};
+
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t depth) : slots_(depth ? depth : 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t depth() const { return slots_.size(); }
+
+    // Direct slot access for setup (e.g. sizing buffers); not while running
+    T& slot(size_t i) { return slots_[i]; }
+
+    // Rewinds the counters; only while neither side is running
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        closed_.store(false, std::memory_order_relaxed);
+        cached_head_ = cached_tail_ = 0;
+        producer_ = ProducerStats();
+        consumer_ = ConsumerStats();
+    }
+
+    // --- Producer ---
+    // Next free slot, waiting while all `depth` slots are in flight
+    T& acquire_write() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= slots_.size()) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= slots_.size()) {
+                TRACE_SCOPE("ring-full");
+                auto t0 = std::chrono::steady_clock::now();
+                producer_.stalls++;
+                for (int spins = 0; head - cached_tail_ >= slots_.size(); spins++) {
+                    wait(spins);
+                    cached_tail_ = tail_.load(std::memory_order_acquire);
+                }
+                producer_.stall_ns += elapsed_ns(t0);
+            }
+        }
+        return slots_[head % slots_.size()];
+    }
+
+    // Hands the slot from acquire_write() to the consumer
+    void publish() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // No more slots will be published; the consumer drains the rest
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // --- Consumer ---
+    // Oldest published slot, waiting while the ring is empty; nullptr once
+    // the producer has closed the ring and everything has been drained
+    T* acquire_read() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_) {
+                TRACE_SCOPE("ring-empty");
+                auto t0 = std::chrono::steady_clock::now();
+                consumer_.starves++;
+                for (int spins = 0; tail == cached_head_; spins++) {
+                    // Check `closed_` before re-reading head_, so a final
+                    // publish() made before close() is never missed
+                    bool closed = closed_.load(std::memory_order_acquire);
+                    cached_head_ = head_.load(std::memory_order_acquire);
+                    if (tail != cached_head_) break;
+                    if (closed) {
+                        consumer_.starve_ns += elapsed_ns(t0);
+                        return nullptr;
+                    }
+                    wait(spins);
+                }
+                consumer_.starve_ns += elapsed_ns(t0);
+            }
+        }
+        return &slots_[tail % slots_.size()];
+    }
+
+    // Returns the slot from acquire_read() to the producer
+    void release() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Read once both sides have finished (e.g. after joining the consumer)
+    SpscRingStats stats() const {
+        SpscRingStats s;
+        s.producer_stalls = producer_.stalls;
+        s.consumer_starves = consumer_.starves;
+        s.producer_stall_ms = (double)producer_.stall_ns / 1e6;
+        s.consumer_starve_ms = (double)consumer_.starve_ns / 1e6;
+        return s;
+    }
+
+private:
+    static void wait(int spins) {
+        if (spins < 64) return;
+        std::this_thread::yield();
+    }
+
+    static uint64_t elapsed_ns(std::chrono::steady_clock::time_point t0) {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+    }
+
+    struct ProducerStats { uint64_t stalls = 0, stall_ns = 0; };
+    struct ConsumerStats { uint64_t starves = 0, starve_ns = 0; };
+
+    std::vector<T> slots_;
+
+    // Producer-owned line: its counter, its cached view of tail_, its stats
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;
+    ProducerStats producer_;
+
+    // Consumer-owned line
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_ = 0;
+    ConsumerStats consumer_;
+
+    alignas(64) std::atomic<bool> closed_{false};
+};
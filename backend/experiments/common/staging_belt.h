@@ -0,0 +1,216 @@
+#pragma once
+// Staging-belt allocator for CPU -> GPU uploads.
+//
+// Keeps a pool of MapWrite | CopySrc chunks instead of creating a staging
+// buffer per upload. write() sub-allocates linearly from the currently mapped
+// chunk, copies the data in and records a copyBufferToBuffer to the
+// destination. finish() unmaps the chunks used so far (call it before
+// submitting the encoder). recall() (after the submit) requests MapAsync on
+// them. The map resolves once the copies have executed, and its callback
+// returns the chunk, mapped again, to the free list. New chunks are created
+// mappedAtCreation, so the first fill does not wait on a map either.
+//
+//   belt.init(device, 16 << 20, 3);
+//   // Per frame
+//   belt.write(encoder, dst, 0, data, size);
+//   belt.finish();
+//   wgpuQueueSubmit(...);
+//   belt.recall();
+//
+// Map callbacks only fire while yielding, so a belt is used from one thread.
+
+#include <emscripten/emscripten.h>
+#include <webgpu/webgpu.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "trace.h"
+
+struct StagingBeltStats {
+    int chunks = 0;             // Currently owned, free or in flight
+    int created = 0;
+    int reused = 0;             // Allocations served by a recalled chunk
+    int map_waits = 0;          // Allocations that had to wait for a recall
+    double map_wait_ms = 0;
+    int map_failures = 0;       // Chunks dropped because their MapAsync failed
+};
+
+class StagingBelt {
+public:
+    StagingBelt() = default;
+    StagingBelt(const StagingBelt&) = delete;
+    StagingBelt& operator=(const StagingBelt&) = delete;
+    ~StagingBelt() { release(); }
+
+    // `chunk_size` is the default chunk size (larger writes get a dedicated
+    // chunk); at most `max_chunks` are created before allocations wait for a
+    // recalled one.
+    void init(WGPUDevice device, uint64_t chunk_size, int max_chunks) {
+        release();
+        device_ = device;
+        chunk_size_ = align(chunk_size);
+        max_chunks_ = max_chunks > 0 ? max_chunks : 1;
+    }
+
+    // Waits (up to `timeout_ms`) for in-flight maps, then frees every chunk.
+    // Chunks still in flight after the timeout are leaked, since their
+    // callbacks may yet fire.
+    void release(double timeout_ms = 2000.0) {
+        finish();
+        double deadline = emscripten_get_now() + timeout_ms;
+        while (in_flight_ > 0 && emscripten_get_now() < deadline) emscripten_sleep(1);
+        for (auto& chunk : chunks_) {
+            if (chunk->in_flight) {
+                chunk->belt = nullptr;  // Orphaned: on_mapped ignores it
+                chunk.release();
+                continue;
+            }
+            wgpuBufferRelease(chunk->buffer);
+        }
+        chunks_.clear();
+        free_.clear();
+        closed_.clear();
+        active_ = nullptr;
+        in_flight_ = 0;
+    }
+
+    // Mapped space for `size` bytes that will be copied to dst at dst_offset
+    // when the encoder is submitted; valid until finish()
+    void* allocate(WGPUCommandEncoder encoder, WGPUBuffer dst, uint64_t dst_offset, uint64_t size) {
+        uint64_t aligned = align(size);
+        if (!active_ || active_->offset + aligned > active_->size) {
+            if (active_) closed_.push_back(active_);
+            active_ = acquire_chunk(aligned);
+            if (!active_) return nullptr;
+        }
+        uint64_t offset = active_->offset;
+        active_->offset += aligned;
+        wgpuCommandEncoderCopyBufferToBuffer(encoder, active_->buffer, offset, dst, dst_offset, size);
+        return active_->mapped + offset;
+    }
+
+    bool write(WGPUCommandEncoder encoder, WGPUBuffer dst, uint64_t dst_offset, const void* data, uint64_t size) {
+        void* ptr = allocate(encoder, dst, dst_offset, size);
+        if (!ptr) return false;
+        std::memcpy(ptr, data, size);
+        return true;
+    }
+
+    // Unmaps the chunks written since the last recall(); before submitting
+    void finish() {
+        if (active_) closed_.push_back(active_);
+        active_ = nullptr;
+        for (Chunk* chunk : closed_) {
+            if (!chunk->mapped) continue;
+            wgpuBufferUnmap(chunk->buffer);
+            chunk->mapped = nullptr;
+        }
+    }
+
+    // Starts remapping the finished chunks; after the submit that reads them
+    void recall() {
+        for (Chunk* chunk : closed_) {
+            chunk->in_flight = true;
+            in_flight_++;
+            wgpuBufferMapAsync(chunk->buffer, WGPUMapMode_Write, 0, chunk->size, on_mapped, chunk);
+        }
+        closed_.clear();
+    }
+
+    StagingBeltStats stats() const {
+        StagingBeltStats s = stats_;
+        s.chunks = (int)chunks_.size();
+        return s;
+    }
+
+private:
+    struct Chunk {
+        StagingBelt* belt;
+        WGPUBuffer buffer;
+        uint64_t size;
+        uint64_t offset;            // Next free byte while mapped
+        uint8_t* mapped;
+        bool in_flight;
+    };
+
+    // copyBufferToBuffer offsets and sizes must be multiples of 4
+    static uint64_t align(uint64_t size) { return (size + 3) & ~uint64_t(3); }
+
+    static void on_mapped(WGPUBufferMapAsyncStatus status, void* userdata) {
+        Chunk* chunk = (Chunk*)userdata;
+        StagingBelt* belt = chunk->belt;
+        if (!belt) return;
+        chunk->in_flight = false;
+        belt->in_flight_--;
+        if (status != WGPUBufferMapAsyncStatus_Success) {
+            belt->stats_.map_failures++;
+            belt->drop(chunk);
+            return;
+        }
+        chunk->mapped = (uint8_t*)wgpuBufferGetMappedRange(chunk->buffer, 0, chunk->size);
+        chunk->offset = 0;
+        belt->free_.push_back(chunk);
+    }
+
+    Chunk* acquire_chunk(uint64_t min_size) {
+        if (Chunk* chunk = take_free(min_size)) return chunk;
+        if ((int)chunks_.size() < max_chunks_ || min_size > chunk_size_) return create_chunk(std::max(chunk_size_, min_size));
+
+        // Pool is full: wait for a recalled chunk to map again
+        TRACE_SCOPE("belt-map-wait");
+        double t0 = emscripten_get_now();
+        stats_.map_waits++;
+        Chunk* chunk = nullptr;
+        while (!(chunk = take_free(min_size)) && in_flight_ > 0) emscripten_sleep(1);
+        stats_.map_wait_ms += emscripten_get_now() - t0;
+        return chunk ? chunk : create_chunk(std::max(chunk_size_, min_size));
+    }
+
+    Chunk* take_free(uint64_t min_size) {
+        for (size_t i = 0; i < free_.size(); i++) {
+            Chunk* chunk = free_[i];
+            if (chunk->size < min_size) continue;
+            free_.erase(free_.begin() + i);
+            stats_.reused++;
+            return chunk;
+        }
+        return nullptr;
+    }
+
+    Chunk* create_chunk(uint64_t size) {
+        WGPUBufferDescriptor desc = {};
+        desc.size = size;
+        desc.usage = WGPUBufferUsage_MapWrite | WGPUBufferUsage_CopySrc;
+        desc.mappedAtCreation = true;
+        WGPUBuffer buffer = wgpuDeviceCreateBuffer(device_, &desc);
+        if (!buffer) return nullptr;
+
+        uint8_t* mapped = (uint8_t*)wgpuBufferGetMappedRange(buffer, 0, size);
+        chunks_.push_back(std::unique_ptr<Chunk>(new Chunk{this, buffer, size, 0, mapped, false}));
+        stats_.created++;
+        return chunks_.back().get();
+    }
+
+    void drop(Chunk* chunk) {
+        wgpuBufferRelease(chunk->buffer);
+        for (size_t i = 0; i < chunks_.size(); i++) {
+            if (chunks_[i].get() != chunk) continue;
+            chunks_.erase(chunks_.begin() + i);
+            break;
+        }
+    }
+
+    WGPUDevice device_ = nullptr;
+    uint64_t chunk_size_ = 0;
+    int max_chunks_ = 1;
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::vector<Chunk*> free_;      // Mapped, offset 0
+    std::vector<Chunk*> closed_;    // Written this frame, awaiting finish()/recall()
+    Chunk* active_ = nullptr;
+    int in_flight_ = 0;
+    StagingBeltStats stats_;
+};
@@ -0,0 +1,227 @@
+#pragma once
+// Instrumented mutex / condition variable wrappers and a contention summary.
+//
+// Drop-in replacements for std::mutex and std::condition_variable that count,
+// per named primitive:
+//   mutex      lock() calls, how many found the lock held, time to acquire,
+//              and (separately) relocks by condvar waits returning
+//   condvar    waits, time blocked, wakeups, spurious wakeups (woke with the
+//              predicate still false), notifies, notify-to-wake latency (from
+//              the latest notify to the waiter running again)
+// Stats live in a process-wide registry keyed by name, so short-lived
+// primitives (one per benchmark run) accumulate into one row, and
+// sync_stats_print() / SyncSummary print the table at the end. Contended
+// acquires and waits also show up as "lock-wait" / "cv-wait" spans in
+// common/trace.h timelines.
+//
+//   InstrumentedMutex mtx("upload/mtx");
+//   InstrumentedCondVar cv("upload/cv_upload");
+//   std::unique_lock<InstrumentedMutex> lk(mtx);
+//   cv.wait(lk, [] { return ready; });
+//
+// Counters are relaxed atomics; the wrappers add two clock reads to a
+// contended acquire and to every wait, nothing to an uncontended lock.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+#include "trace.h"
+
+struct SyncStats {
+    std::string name;
+    std::atomic<uint64_t> acquires{0};
+    std::atomic<uint64_t> contended{0};         // Acquires that found the mutex held
+    std::atomic<uint64_t> acquire_ns{0};        // Blocked in lock()
+    std::atomic<uint64_t> relocks{0};           // Re-acquired by a returning condvar wait (timed in its wait_ns)
+    std::atomic<uint64_t> waits{0};             // Condvar wait() calls that blocked
+    std::atomic<uint64_t> wait_ns{0};
+    std::atomic<uint64_t> wakeups{0};
+    std::atomic<uint64_t> spurious{0};
+    std::atomic<uint64_t> notifies{0};
+    std::atomic<uint64_t> notify_wake_ns{0};
+    std::atomic<uint64_t> notify_wake_samples{0};
+
+    explicit SyncStats(const std::string& n) : name(n) {}
+};
+
+inline uint64_t sync_now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct SyncRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<SyncStats>> stats;
+};
+
+inline SyncRegistry sync_registry;
+
+// The stats row for `name`, created on first use; lives until exit
+inline SyncStats& sync_stats(const std::string& name) {
+    std::lock_guard<std::mutex> lock(sync_registry.mutex);
+    for (auto& s : sync_registry.stats) {
+        if (s->name == name) return *s;
+    }
+    sync_registry.stats.emplace_back(new SyncStats(name));
+    return *sync_registry.stats.back();
+}
+
+// BasicLockable, so it works with std::unique_lock / std::lock_guard
+class InstrumentedMutex {
+public:
+    explicit InstrumentedMutex(const std::string& name) : stats_(&sync_stats(name)) {}
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock() {
+        stats_->acquires.fetch_add(1, std::memory_order_relaxed);
+        if (mutex_.try_lock()) return;
+        TRACE_SCOPE("lock-wait");
+        uint64_t t0 = sync_now_ns();
+        mutex_.lock();
+        stats_->contended.fetch_add(1, std::memory_order_relaxed);
+        stats_->acquire_ns.fetch_add(sync_now_ns() - t0, std::memory_order_relaxed);
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) return false;
+        stats_->acquires.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock() { mutex_.unlock(); }
+
+    // Re-acquire at the end of a condvar wait. Counted apart from lock():
+    // the wait's time already includes it, and the notifier often still
+    // holds the mutex, which would read as contention.
+    void relock() {
+        stats_->relocks.fetch_add(1, std::memory_order_relaxed);
+        mutex_.lock();
+    }
+
+private:
+    std::mutex mutex_;
+    SyncStats* stats_;
+};
+
+class InstrumentedCondVar {
+public:
+    explicit InstrumentedCondVar(const std::string& name) : stats_(&sync_stats(name)) {}
+    InstrumentedCondVar(const InstrumentedCondVar&) = delete;
+    InstrumentedCondVar& operator=(const InstrumentedCondVar&) = delete;
+
+    // Waits until pred() holds; `lock` must own its mutex
+    template <typename Pred>
+    void wait(std::unique_lock<InstrumentedMutex>& lock, Pred pred) {
+        if (pred()) return;
+        TRACE_SCOPE("cv-wait");
+        stats_->waits.fetch_add(1, std::memory_order_relaxed);
+        // condition_variable_any unlocks / relocks this instead of `lock`, so
+        // wake-up relocks do not count as lock() calls; `lock` still owns the
+        // mutex throughout as far as its own state goes
+        WaitRelock relock{*lock.mutex()};
+        uint64_t t0 = sync_now_ns();
+        for (;;) {
+            uint64_t blocked = sync_now_ns();
+            cv_.wait(relock);
+            uint64_t woke = sync_now_ns();
+            stats_->wakeups.fetch_add(1, std::memory_order_relaxed);
+            uint64_t notified = last_notify_ns_.load(std::memory_order_relaxed);
+            if (notified >= blocked && notified <= woke) {
+                stats_->notify_wake_ns.fetch_add(woke - notified, std::memory_order_relaxed);
+                stats_->notify_wake_samples.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (pred()) break;
+            stats_->spurious.fetch_add(1, std::memory_order_relaxed);
+        }
+        stats_->wait_ns.fetch_add(sync_now_ns() - t0, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        note_notify();
+        cv_.notify_one();
+    }
+
+    void notify_all() {
+        note_notify();
+        cv_.notify_all();
+    }
+
+private:
+    struct WaitRelock {
+        InstrumentedMutex& mutex;
+        void lock() { mutex.relock(); }
+        void unlock() { mutex.unlock(); }
+    };
+
+    void note_notify() {
+        stats_->notifies.fetch_add(1, std::memory_order_relaxed);
+        last_notify_ns_.store(sync_now_ns(), std::memory_order_relaxed);
+    }
+
+    std::condition_variable_any cv_;  // Any lock type, so it can wait on InstrumentedMutex
+    std::atomic<uint64_t> last_notify_ns_{0};
+    SyncStats* stats_;
+};
+
+// Zeroes every row (names are kept)
+inline void sync_stats_reset() {
+    std::lock_guard<std::mutex> lock(sync_registry.mutex);
+    for (auto& s : sync_registry.stats) {
+        for (std::atomic<uint64_t>* c : {&s->acquires, &s->contended, &s->acquire_ns, &s->relocks, &s->waits,
+                                         &s->wait_ns, &s->wakeups, &s->spurious, &s->notifies, &s->notify_wake_ns,
+                                         &s->notify_wake_samples}) {
+            c->store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// One row per primitive that saw any traffic, plus a `sync/<name>` RESULT line
+// each; returns the number of rows
+inline int sync_stats_print() {
+    std::lock_guard<std::mutex> lock(sync_registry.mutex);
+    int rows = 0;
+    for (auto& s : sync_registry.stats) {
+        uint64_t acquires = s->acquires.load(), contended = s->contended.load(), relocks = s->relocks.load();
+        uint64_t waits = s->waits.load();
+        uint64_t wakeups = s->wakeups.load(), spurious = s->spurious.load(), notifies = s->notifies.load();
+        uint64_t samples = s->notify_wake_samples.load();
+        if (acquires == 0 && waits == 0 && notifies == 0) continue;
+        if (rows++ == 0) {
+            std::printf("[sync] %-36s %10s %9s %11s %8s %8s %11s %8s %9s %8s %13s\n", "primitive", "acquires",
+                        "contended", "acquire ms", "relocks", "waits", "wait ms", "wakeups", "spurious", "notifies",
+                        "notify->wake");
+        }
+        double acquireMs = s->acquire_ns.load() / 1e6, waitMs = s->wait_ns.load() / 1e6;
+        double wakeUs = samples ? s->notify_wake_ns.load() / 1e3 / samples : 0.0;
+        std::printf("[sync] %-36s %10llu %9llu %11.3f %8llu %8llu %11.3f %8llu %9llu %8llu %10.1f us\n",
+                    s->name.c_str(), (unsigned long long)acquires, (unsigned long long)contended, acquireMs,
+                    (unsigned long long)relocks, (unsigned long long)waits, waitMs, (unsigned long long)wakeups,
+                    (unsigned long long)spurious, (unsigned long long)notifies, wakeUs);
+        std::printf("RESULT: {\"name\":\"sync/%s\",\"acquires\":%llu,\"contended\":%llu,\"acquireMs\":%.6g,"
+                    "\"relocks\":%llu,\"waits\":%llu,\"waitMs\":%.6g,\"wakeups\":%llu,\"spurious\":%llu,\"notifies\":%llu,"
+                    "\"notifyToWakeUs\":%.6g}\n",
+                    bench_json_escape(s->name).c_str(), (unsigned long long)acquires, (unsigned long long)contended,
+                    acquireMs, (unsigned long long)relocks, (unsigned long long)waits, waitMs, (unsigned long long)wakeups,
+                    (unsigned long long)spurious, (unsigned long long)notifies, wakeUs);
+    }
+    std::fflush(stdout);
+    return rows;
+}
+
+// Prints the table when it goes out of scope (e.g. at the end of main)
+class SyncSummary {
+public:
+    SyncSummary() {}
+    ~SyncSummary() { sync_stats_print(); }
+    SyncSummary(const SyncSummary&) = delete;
+    SyncSummary& operator=(const SyncSummary&) = delete;
+};
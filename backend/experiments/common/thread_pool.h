@@ -0,0 +1,275 @@
+#pragma once
+// Persistent work-stealing thread pool shared by the C++ experiments.
+//
+// Threads are created once (sized from hardware_concurrency) and parked on a
+// condition variable between jobs, so a per-frame parallel_for costs a wake-up
+// instead of a thread spawn + join. Each worker owns a Chase-Lev deque; the
+// submitting thread pushes chunk tasks to its deque, then helps run them while
+// idle workers steal from the top.
+//
+// Usage:
+//   ThreadPool::instance().parallel_for(0, n, 256, [&](size_t begin, size_t end) { ... });
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "trace.h"
+
+// One contiguous slice of a parallel_for. Lives on the submitter's stack until
+// `pending` reaches zero.
+struct PoolTask {
+    void (*fn)(void* ctx, size_t begin, size_t end);
+    void* ctx;
+    size_t begin;
+    size_t end;
+    std::atomic<size_t>* pending;
+};
+
+// --- Chase-Lev Deque ---
+// Fixed-capacity variant of "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Le et al., PPoPP'13). Only the owner calls push/pop (bottom
+// end); any thread may steal (top end).
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(size_t capacity = 1024)
+        : buffer_(new std::atomic<PoolTask*>[capacity]), mask_((int64_t)capacity - 1) {
+        // Capacity must be a power of two
+        for (size_t i = 0; i < capacity; i++) buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Returns false when full; caller runs the task inline instead.
+    bool push(PoolTask* task) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t > mask_) return false;
+        // Release on the slot itself (not just the fence) so ThreadSanitizer,
+        // which ignores standalone fences, sees the hand-off to thieves.
+        buffer_[b & mask_].store(task, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    PoolTask* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        PoolTask* task = buffer_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last element: race a concurrent steal for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    PoolTask* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+
+        PoolTask* task = buffer_[t & mask_].load(std::memory_order_acquire);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr; // Lost the race to another thief or the owner
+        }
+        return task;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    std::unique_ptr<std::atomic<PoolTask*>[]> buffer_;
+    int64_t mask_;
+};
+
+// --- Thread Pool ---
+class ThreadPool {
+public:
+    // Most slices a single parallel_for is split into
+    static constexpr size_t kMaxTasks = 256;
+
+    // `num_threads` counts the submitting thread, which always helps; the pool
+    // spawns num_threads - 1 workers.
+    explicit ThreadPool(unsigned num_threads)
+        : deques_(std::max(1u, num_threads)) {
+        for (unsigned i = 1; i < deques_.size(); i++) {
+            workers_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lk(sleep_mtx_);
+            stop_.store(true);
+            epoch_.fetch_add(1);
+        }
+        sleep_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Process-wide pool sized from std::thread::hardware_concurrency()
+    static ThreadPool& instance() {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    // Threads that execute tasks, including the caller of parallel_for
+    unsigned size() const { return (unsigned)deques_.size(); }
+
+    // Runs fn(begin, end) over [begin, end) split into slices of at least
+    // `grain` items and blocks until every slice has finished.
+    template <typename Fn>
+    void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (end <= begin) return;
+        size_t n = end - begin;
+        size_t slices = std::min(kMaxTasks, (n + std::max<size_t>(1, grain) - 1) / std::max<size_t>(1, grain));
+        if (slices <= 1 || workers_.empty()) {
+            fn(begin, end);
+            return;
+        }
+
+        using FnType = typename std::remove_reference<Fn>::type;
+        auto trampoline = [](void* ctx, size_t b, size_t e) { (*static_cast<FnType*>(ctx))(b, e); };
+
+        std::atomic<size_t> pending(slices);
+        PoolTask tasks[kMaxTasks];
+        size_t step = n / slices;
+        size_t extra = n % slices;
+        size_t cursor = begin;
+        for (size_t s = 0; s < slices; s++) {
+            size_t len = step + (s < extra ? 1 : 0);
+            tasks[s] = PoolTask{trampoline, (void*)&fn, cursor, cursor + len, &pending};
+            cursor += len;
+        }
+
+        // Workers push to their own deque (nested parallelism); any other
+        // thread takes the external submission slot, deque 0, and keeps it
+        // for nested calls made from the slices it runs itself.
+        int self = worker_index();
+        std::unique_lock<std::mutex> submit_lock(submit_mtx_, std::defer_lock);
+        const ThreadPool* outer_submitter = tls_submitter();
+        if (self < 0) {
+            if (outer_submitter != this) submit_lock.lock();
+            tls_submitter() = this;
+            self = 0;
+        }
+        WorkStealingDeque& own = deques_[self];
+
+        // Push in reverse so the owner pops slices in ascending order
+        for (size_t s = slices; s-- > 0;) {
+            if (!own.push(&tasks[s])) run(&tasks[s]);
+        }
+        wake_workers();
+
+        while (pending.load(std::memory_order_acquire) != 0) {
+            PoolTask* task = own.pop();
+            if (!task) task = steal_from_others(self);
+            if (task) run(task);
+            else std::this_thread::yield();
+        }
+        tls_submitter() = outer_submitter;
+    }
+
+private:
+    static int& tls_worker_index() {
+        static thread_local int index = -1;
+        return index;
+    }
+
+    int worker_index() const {
+        // Only meaningful for this pool's workers; another pool's worker
+        // submitting here is treated as external.
+        return tls_owner() == this ? tls_worker_index() : -1;
+    }
+
+    static const ThreadPool*& tls_owner() {
+        static thread_local const ThreadPool* owner = nullptr;
+        return owner;
+    }
+
+    // Pool whose deque 0 this (non-worker) thread currently owns
+    static const ThreadPool*& tls_submitter() {
+        static thread_local const ThreadPool* submitter = nullptr;
+        return submitter;
+    }
+
+    static void run(PoolTask* task) {
+        task->fn(task->ctx, task->begin, task->end);
+        task->pending->fetch_sub(1, std::memory_order_release);
+    }
+
+    PoolTask* steal_from_others(int self) {
+        size_t count = deques_.size();
+        for (size_t k = 1; k <= count; k++) {
+            size_t victim = (self + k) % count;
+            if ((int)victim == self) continue;
+            if (PoolTask* task = deques_[victim].steal()) return task;
+        }
+        return nullptr;
+    }
+
+    void wake_workers() {
+        {
+            std::lock_guard<std::mutex> lk(sleep_mtx_);
+            epoch_.fetch_add(1);
+        }
+        sleep_cv_.notify_all();
+    }
+
+    void worker_loop(int index) {
+        trace_set_thread_name("pool-worker");
+        tls_owner() = this;
+        tls_worker_index() = index;
+        const int kIdleSpins = 64;
+        int idle = 0;
+
+        while (!stop_.load()) {
+            uint64_t seen = epoch_.load();
+            PoolTask* task = deques_[index].pop();
+            if (!task) task = steal_from_others(index);
+            if (task) {
+                run(task);
+                idle = 0;
+                continue;
+            }
+            if (++idle < kIdleSpins) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Park until the next submission
+            std::unique_lock<std::mutex> lk(sleep_mtx_);
+            sleep_cv_.wait(lk, [&] { return stop_.load() || epoch_.load() != seen; });
+            idle = 0;
+        }
+    }
+
+    std::vector<WorkStealingDeque> deques_; // [0] = external submitter, [i] = worker i
+    std::vector<std::thread> workers_;
+    std::mutex submit_mtx_;                 // Serialises external submitters on deque 0
+
+    std::mutex sleep_mtx_;
+    std::condition_variable sleep_cv_;
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<bool> stop_{false};
+};
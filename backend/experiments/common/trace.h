@@ -0,0 +1,249 @@
+#pragma once
+// Per-thread timeline tracing, dumped as Chrome trace-event JSON (open in
+// chrome://tracing or ui.perfetto.dev).
+//
+// Every thread that records gets its own fixed ring of events on first use.
+// When a thread exits its ring is kept, and the next thread with the same name
+// reuses it (one "uploader" lane however many uploader threads come and go).
+// Only the owning thread writes to a ring, so recording takes no lock: fill a
+// slot, then publish it by bumping the head with a release store. A full ring
+// wraps and keeps the newest events (flight-recorder style). A scope is
+// stored as one complete ("X") event holding its start and duration, so a
+// wrapped ring never leaves an unmatched begin or end. Timestamps come from
+// bench_now_ms() (emscripten_get_now or steady_clock).
+//
+//   trace_enable(true);
+//   trace_set_thread_name("uploader");  // Any time, traced or not
+//   { TRACE_SCOPE("map-wait"); ... }    // One "X" event per scope exit
+//   TRACE_INSTANT("frame-dropped");     // One "i" event
+//   trace_write_file("swarm.trace.json");
+//
+// Event names are stored by pointer, so they must outlive the dump (string
+// literals). Disabled tracing costs one relaxed load per scope. Dump and
+// reset only while the traced threads are idle (e.g. after join()).
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench_harness.h"
+
+const size_t TRACE_RING_EVENTS = 1 << 15; // Per thread, power of two (768 KiB)
+
+struct TraceEvent {
+    const char* name;
+    double ts_ms;   // Start, bench_now_ms()
+    double dur_ms;  // < 0 for an instant event
+};
+
+class TraceRing {
+public:
+    explicit TraceRing(int tid) : tid_(tid), events_(TRACE_RING_EVENTS) {}
+
+    // Owner thread only
+    void push(const char* name, double ts_ms, double dur_ms) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        TraceEvent& e = events_[head & (TRACE_RING_EVENTS - 1)];
+        e.name = name;
+        e.ts_ms = ts_ms;
+        e.dur_ms = dur_ms;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    int tid() const { return tid_; }
+    uint64_t head() const { return head_.load(std::memory_order_acquire); }
+    const TraceEvent& at(uint64_t i) const { return events_[i & (TRACE_RING_EVENTS - 1)]; }
+    void clear() { head_.store(0, std::memory_order_relaxed); }
+
+    std::string name;   // Set by trace_set_thread_name(); empty = "thread-<tid>"
+    bool in_use = false; // Owned by a live thread; guarded by TraceState::mutex
+
+private:
+    int tid_;
+    std::atomic<uint64_t> head_{0};
+    std::vector<TraceEvent> events_;
+};
+
+struct TraceState {
+    std::atomic<bool> enabled{false};
+    std::mutex mutex;                               // Guards `rings` (registration and dump)
+    std::vector<std::unique_ptr<TraceRing>> rings;  // Outlive their threads
+};
+
+inline TraceState trace_state;
+
+inline bool trace_enabled() {
+    return trace_state.enabled.load(std::memory_order_relaxed);
+}
+
+inline void trace_enable(bool on) {
+    trace_state.enabled.store(on, std::memory_order_relaxed);
+}
+
+inline const char*& trace_thread_label() {
+    thread_local const char* label = nullptr;
+    return label;
+}
+
+// Hands the thread's ring back when the thread exits
+struct TraceRingLease {
+    TraceRing* ring = nullptr;
+    ~TraceRingLease() {
+        if (!ring) return;
+        std::lock_guard<std::mutex> lock(trace_state.mutex);
+        ring->in_use = false;
+    }
+};
+
+inline TraceRing*& trace_thread_ring_ptr() {
+    thread_local TraceRingLease lease;
+    return lease.ring;
+}
+
+// This thread's ring, taken on first use (the only locked path): a free ring
+// left by an exited thread of the same name, else a new one
+inline TraceRing& trace_thread_ring() {
+    TraceRing*& ring = trace_thread_ring_ptr();
+    if (!ring) {
+        std::lock_guard<std::mutex> lock(trace_state.mutex);
+        const char* label = trace_thread_label();
+        for (auto& r : trace_state.rings) {
+            if (!r->in_use && label && r->name == label) {
+                ring = r.get();
+                break;
+            }
+        }
+        if (!ring) {
+            trace_state.rings.emplace_back(new TraceRing((int)trace_state.rings.size()));
+            ring = trace_state.rings.back().get();
+            if (label) ring->name = label;
+        }
+        ring->in_use = true;
+    }
+    return *ring;
+}
+
+// Label for this thread's lane in the viewer. Cheap whether or not tracing is
+// on, so long-lived threads can name themselves at startup.
+inline void trace_set_thread_name(const char* name) {
+    trace_thread_label() = name;
+    if (TraceRing* ring = trace_thread_ring_ptr()) {
+        std::lock_guard<std::mutex> lock(trace_state.mutex);
+        ring->name = name;
+    }
+}
+
+inline void trace_instant(const char* name) {
+    if (trace_enabled()) trace_thread_ring().push(name, bench_now_ms(), -1.0);
+}
+
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : name_(trace_enabled() ? name : nullptr) {
+        if (name_) start_ms_ = bench_now_ms();
+    }
+    ~TraceScope() {
+        if (name_) trace_thread_ring().push(name_, start_ms_, bench_now_ms() - start_ms_);
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+    double start_ms_ = 0.0;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_INSTANT(name) trace_instant(name)
+
+// Drops every recorded event; thread names and rings are kept
+inline void trace_reset() {
+    std::lock_guard<std::mutex> lock(trace_state.mutex);
+    for (auto& ring : trace_state.rings) ring->clear();
+}
+
+// Chrome trace-event JSON: one lane per ring, microseconds relative to the
+// earliest retained event
+inline size_t trace_write_json(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(trace_state.mutex);
+    double origin = -1.0;
+    for (auto& ring : trace_state.rings) {
+        uint64_t head = ring->head();
+        for (uint64_t i = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0; i < head; i++) {
+            if (origin < 0.0 || ring->at(i).ts_ms < origin) origin = ring->at(i).ts_ms;
+        }
+    }
+
+    size_t written = 0;
+    char buf[96];
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char* sep = "\n";
+    for (auto& ring : trace_state.rings) {
+        std::string lane = ring->name.empty() ? "thread-" + std::to_string(ring->tid()) : ring->name;
+        out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid()
+            << ",\"args\":{\"name\":\"" << bench_json_escape(lane) << "\"}}";
+        sep = ",\n";
+        uint64_t head = ring->head();
+        for (uint64_t i = head > TRACE_RING_EVENTS ? head - TRACE_RING_EVENTS : 0; i < head; i++) {
+            const TraceEvent& e = ring->at(i);
+            out << sep << "{\"name\":\"" << bench_json_escape(e.name) << "\",\"pid\":1,\"tid\":" << ring->tid();
+            if (e.dur_ms >= 0.0) {
+                std::snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f}",
+                              (e.ts_ms - origin) * 1000.0, e.dur_ms * 1000.0);
+            } else {
+                std::snprintf(buf, sizeof(buf), ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f}", (e.ts_ms - origin) * 1000.0);
+            }
+            out << buf;
+            written++;
+        }
+    }
+    out << "\n]}\n";
+    return written;
+}
+
+inline std::string trace_json() {
+    std::ostringstream out;
+    trace_write_json(out);
+    return out.str();
+}
+
+// Writes the trace to `path` and prints where it went; returns the event count
+inline size_t trace_write_file(const char* path) {
+    std::ofstream out(path);
+    size_t events = trace_write_json(out);
+    std::printf("[trace] wrote %zu events from %zu threads to %s\n", events, trace_state.rings.size(), path);
+    std::fflush(stdout);
+    return events;
+}
+
+// Traces for its lifetime and writes the trace to `path` when it ends, so a
+// main() with several return paths needs one line (no-op when path is null)
+class TraceSession {
+public:
+    explicit TraceSession(const char* path) : path_(path) {
+        if (!path_) return;
+        trace_enable(true);
+        trace_set_thread_name("main");
+    }
+    ~TraceSession() {
+        if (!path_) return;
+        trace_enable(false);
+        trace_write_file(path_);
+    }
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+
+private:
+    const char* path_;
+};
@@ -0,0 +1,24 @@
+// Native implementation of the emscripten.h stand-in.
+
+#include <emscripten/emscripten.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static std::atomic<native_event_pump> g_event_pump(nullptr);
+
+extern "C" double emscripten_get_now(void) {
+    using namespace std::chrono;
+    static const steady_clock::time_point start = steady_clock::now();
+    return duration<double, std::milli>(steady_clock::now() - start).count();
+}
+
+extern "C" void emscripten_sleep(unsigned int ms) {
+    if (native_event_pump pump = g_event_pump.load()) pump();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+extern "C" void native_set_event_pump(native_event_pump pump) {
+    g_event_pump.store(pump);
+}
@@ -0,0 +1,56 @@
+#pragma once
+// Native stand-in for <emscripten/bind.h>. EMSCRIPTEN_BINDINGS blocks still
+// compile and run at static-init time; function() records the exported names
+// so a native harness can list them, but nothing is exposed to JS.
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace emscripten {
+
+inline std::vector<std::string>& native_bound_functions() {
+    static std::vector<std::string> names;
+    return names;
+}
+
+template <typename Fn>
+void function(const char* name, Fn) {
+    native_bound_functions().push_back(name);
+}
+
+// Result of typed_memory_view(): a raw (pointer, length) pair natively
+template <typename T>
+struct memory_view {
+    size_t size;
+    const T* data;
+};
+
+template <typename T>
+memory_view<T> typed_memory_view(size_t size, const T* data) {
+    return memory_view<T>{size, data};
+}
+
+// Opaque stand-in for emscripten::val. Only construction is supported, which
+// is all the experiments need to return a view to JS.
+class val {
+public:
+    val() = default;
+
+    template <typename T>
+    explicit val(const memory_view<T>& view) : data_(view.data), size_(view.size * sizeof(T)) {}
+
+    const void* data() const { return data_; }
+    size_t byte_length() const { return size_; }
+
+private:
+    const void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace emscripten
+
+#define EMSCRIPTEN_BINDINGS(name)                                   \
+    static void embind_init_##name();                               \
+    static const int embind_registered_##name = (embind_init_##name(), 0); \
+    static void embind_init_##name()
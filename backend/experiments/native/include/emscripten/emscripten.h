@@ -0,0 +1,26 @@
+#pragma once
+// Native stand-in for the subset of <emscripten/emscripten.h> the experiments
+// use. Timing comes from std::chrono::steady_clock; emscripten_sleep also pumps
+// pending WebGPU stand-in callbacks, the way yielding to the browser event
+// loop lets real WebGPU callbacks fire.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMSCRIPTEN_KEEPALIVE __attribute__((used))
+
+// Milliseconds since an arbitrary epoch, sub-millisecond resolution
+double emscripten_get_now(void);
+
+// Sleeps for `ms` milliseconds, running queued async callbacks first
+void emscripten_sleep(unsigned int ms);
+
+// Native-only: hook run by emscripten_sleep before sleeping (one slot; the
+// WebGPU stand-in installs itself here when an instance is created).
+typedef void (*native_event_pump)(void);
+void native_set_event_pump(native_event_pump pump);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,314 @@
+#pragma once
+// Native stand-in for the subset of Emscripten's <webgpu/webgpu.h> used by the
+// experiments. Declarations mirror the Emscripten header (same names, struct
+// fields and callback signatures) so the experiments compile unchanged; the
+// implementation in webgpu_standin.cpp is a CPU "device": buffers live in host
+// memory, copies and writes are memcpy, dispatches are counted but run no
+// shader code, timestamp queries return a synthetic GPU clock, and async
+// callbacks fire on the next emscripten_sleep().
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WGPU_WHOLE_SIZE (0xffffffffffffffffULL)
+#define WGPU_WHOLE_MAP_SIZE SIZE_MAX
+#define WGPU_QUERY_SET_INDEX_UNDEFINED (0xffffffffUL)
+
+typedef uint32_t WGPUFlags;
+typedef uint32_t WGPUBool;
+
+// --- Handles ---
+typedef struct WGPUInstanceImpl* WGPUInstance;
+typedef struct WGPUAdapterImpl* WGPUAdapter;
+typedef struct WGPUDeviceImpl* WGPUDevice;
+typedef struct WGPUQueueImpl* WGPUQueue;
+typedef struct WGPUBufferImpl* WGPUBuffer;
+typedef struct WGPUShaderModuleImpl* WGPUShaderModule;
+typedef struct WGPUBindGroupLayoutImpl* WGPUBindGroupLayout;
+typedef struct WGPUBindGroupImpl* WGPUBindGroup;
+typedef struct WGPUPipelineLayoutImpl* WGPUPipelineLayout;
+typedef struct WGPUComputePipelineImpl* WGPUComputePipeline;
+typedef struct WGPUCommandEncoderImpl* WGPUCommandEncoder;
+typedef struct WGPUComputePassEncoderImpl* WGPUComputePassEncoder;
+typedef struct WGPUCommandBufferImpl* WGPUCommandBuffer;
+typedef struct WGPUQuerySetImpl* WGPUQuerySet;
+
+// --- Enums ---
+typedef enum WGPURequestAdapterStatus {
+    WGPURequestAdapterStatus_Success = 0x00000000,
+    WGPURequestAdapterStatus_Unavailable = 0x00000001,
+    WGPURequestAdapterStatus_Error = 0x00000002,
+    WGPURequestAdapterStatus_Unknown = 0x00000003,
+} WGPURequestAdapterStatus;
+
+typedef enum WGPURequestDeviceStatus {
+    WGPURequestDeviceStatus_Success = 0x00000000,
+    WGPURequestDeviceStatus_Error = 0x00000001,
+    WGPURequestDeviceStatus_Unknown = 0x00000002,
+} WGPURequestDeviceStatus;
+
+typedef enum WGPUQueueWorkDoneStatus {
+    WGPUQueueWorkDoneStatus_Success = 0x00000000,
+    WGPUQueueWorkDoneStatus_Error = 0x00000001,
+    WGPUQueueWorkDoneStatus_Unknown = 0x00000002,
+    WGPUQueueWorkDoneStatus_DeviceLost = 0x00000003,
+} WGPUQueueWorkDoneStatus;
+
+typedef enum WGPUBufferMapAsyncStatus {
+    WGPUBufferMapAsyncStatus_Success = 0x00000000,
+    WGPUBufferMapAsyncStatus_ValidationError = 0x00000001,
+    WGPUBufferMapAsyncStatus_Unknown = 0x00000002,
+    WGPUBufferMapAsyncStatus_DeviceLost = 0x00000003,
+    WGPUBufferMapAsyncStatus_DestroyedBeforeCallback = 0x00000004,
+    WGPUBufferMapAsyncStatus_UnmappedBeforeCallback = 0x00000005,
+} WGPUBufferMapAsyncStatus;
+
+typedef enum WGPUFeatureName {
+    WGPUFeatureName_Undefined = 0x00000000,
+    WGPUFeatureName_DepthClipControl = 0x00000001,
+    WGPUFeatureName_Depth32FloatStencil8 = 0x00000002,
+    WGPUFeatureName_TimestampQuery = 0x00000003,
+} WGPUFeatureName;
+
+typedef enum WGPUQueryType {
+    WGPUQueryType_Occlusion = 0x00000000,
+    WGPUQueryType_Timestamp = 0x00000001,
+} WGPUQueryType;
+
+typedef enum WGPUSType {
+    WGPUSType_Invalid = 0x00000000,
+    WGPUSType_ShaderModuleSPIRVDescriptor = 0x00000005,
+    WGPUSType_ShaderModuleWGSLDescriptor = 0x00000006,
+} WGPUSType;
+
+typedef enum WGPUBufferBindingType {
+    WGPUBufferBindingType_Undefined = 0x00000000,
+    WGPUBufferBindingType_Uniform = 0x00000001,
+    WGPUBufferBindingType_Storage = 0x00000002,
+    WGPUBufferBindingType_ReadOnlyStorage = 0x00000003,
+} WGPUBufferBindingType;
+
+typedef enum WGPUBufferUsage {
+    WGPUBufferUsage_None = 0x00000000,
+    WGPUBufferUsage_MapRead = 0x00000001,
+    WGPUBufferUsage_MapWrite = 0x00000002,
+    WGPUBufferUsage_CopySrc = 0x00000004,
+    WGPUBufferUsage_CopyDst = 0x00000008,
+    WGPUBufferUsage_Index = 0x00000010,
+    WGPUBufferUsage_Vertex = 0x00000020,
+    WGPUBufferUsage_Uniform = 0x00000040,
+    WGPUBufferUsage_Storage = 0x00000080,
+    WGPUBufferUsage_Indirect = 0x00000100,
+    WGPUBufferUsage_QueryResolve = 0x00000200,
+} WGPUBufferUsage;
+typedef WGPUFlags WGPUBufferUsageFlags;
+
+typedef enum WGPUMapMode {
+    WGPUMapMode_None = 0x00000000,
+    WGPUMapMode_Read = 0x00000001,
+    WGPUMapMode_Write = 0x00000002,
+} WGPUMapMode;
+typedef WGPUFlags WGPUMapModeFlags;
+
+typedef enum WGPUShaderStage {
+    WGPUShaderStage_None = 0x00000000,
+    WGPUShaderStage_Vertex = 0x00000001,
+    WGPUShaderStage_Fragment = 0x00000002,
+    WGPUShaderStage_Compute = 0x00000004,
+} WGPUShaderStage;
+typedef WGPUFlags WGPUShaderStageFlags;
+
+// --- Callbacks ---
+typedef void (*WGPURequestAdapterCallback)(WGPURequestAdapterStatus status, WGPUAdapter adapter, char const* message, void* userdata);
+typedef void (*WGPURequestDeviceCallback)(WGPURequestDeviceStatus status, WGPUDevice device, char const* message, void* userdata);
+typedef void (*WGPUQueueWorkDoneCallback)(WGPUQueueWorkDoneStatus status, void* userdata);
+typedef void (*WGPUBufferMapCallback)(WGPUBufferMapAsyncStatus status, void* userdata);
+
+// --- Descriptors ---
+typedef struct WGPUChainedStruct {
+    struct WGPUChainedStruct const* next;
+    WGPUSType sType;
+} WGPUChainedStruct;
+
+typedef struct WGPUInstanceDescriptor {
+    WGPUChainedStruct const* nextInChain;
+} WGPUInstanceDescriptor;
+
+typedef struct WGPURequestAdapterOptions {
+    WGPUChainedStruct const* nextInChain;
+    WGPUBool forceFallbackAdapter;
+} WGPURequestAdapterOptions;
+
+typedef struct WGPUDeviceDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    size_t requiredFeatureCount;
+    WGPUFeatureName const* requiredFeatures;
+} WGPUDeviceDescriptor;
+
+typedef struct WGPUShaderModuleWGSLDescriptor {
+    WGPUChainedStruct chain;
+    char const* source;
+} WGPUShaderModuleWGSLDescriptor;
+
+typedef struct WGPUShaderModuleDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+} WGPUShaderModuleDescriptor;
+
+typedef struct WGPUBufferBindingLayout {
+    WGPUChainedStruct const* nextInChain;
+    WGPUBufferBindingType type;
+    WGPUBool hasDynamicOffset;
+    uint64_t minBindingSize;
+} WGPUBufferBindingLayout;
+
+typedef struct WGPUBindGroupLayoutEntry {
+    WGPUChainedStruct const* nextInChain;
+    uint32_t binding;
+    WGPUShaderStageFlags visibility;
+    WGPUBufferBindingLayout buffer;
+} WGPUBindGroupLayoutEntry;
+
+typedef struct WGPUBindGroupLayoutDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    size_t entryCount;
+    WGPUBindGroupLayoutEntry const* entries;
+} WGPUBindGroupLayoutDescriptor;
+
+typedef struct WGPUBindGroupEntry {
+    WGPUChainedStruct const* nextInChain;
+    uint32_t binding;
+    WGPUBuffer buffer;
+    uint64_t offset;
+    uint64_t size;
+} WGPUBindGroupEntry;
+
+typedef struct WGPUBindGroupDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    WGPUBindGroupLayout layout;
+    size_t entryCount;
+    WGPUBindGroupEntry const* entries;
+} WGPUBindGroupDescriptor;
+
+typedef struct WGPUPipelineLayoutDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    size_t bindGroupLayoutCount;
+    WGPUBindGroupLayout const* bindGroupLayouts;
+} WGPUPipelineLayoutDescriptor;
+
+typedef struct WGPUProgrammableStageDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    WGPUShaderModule module;
+    char const* entryPoint;
+} WGPUProgrammableStageDescriptor;
+
+typedef struct WGPUComputePipelineDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    WGPUPipelineLayout layout;
+    WGPUProgrammableStageDescriptor compute;
+} WGPUComputePipelineDescriptor;
+
+typedef struct WGPUBufferDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    WGPUBufferUsageFlags usage;
+    uint64_t size;
+    WGPUBool mappedAtCreation;
+} WGPUBufferDescriptor;
+
+typedef struct WGPUCommandEncoderDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+} WGPUCommandEncoderDescriptor;
+
+typedef struct WGPUQuerySetDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    WGPUQueryType type;
+    uint32_t count;
+} WGPUQuerySetDescriptor;
+
+typedef struct WGPUComputePassTimestampWrites {
+    WGPUQuerySet querySet;
+    uint32_t beginningOfPassWriteIndex;
+    uint32_t endOfPassWriteIndex;
+} WGPUComputePassTimestampWrites;
+
+typedef struct WGPUComputePassDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+    WGPUComputePassTimestampWrites const* timestampWrites;
+} WGPUComputePassDescriptor;
+
+typedef struct WGPUCommandBufferDescriptor {
+    WGPUChainedStruct const* nextInChain;
+    char const* label;
+} WGPUCommandBufferDescriptor;
+
+// --- Functions ---
+WGPUInstance wgpuCreateInstance(WGPUInstanceDescriptor const* descriptor);
+void wgpuInstanceRequestAdapter(WGPUInstance instance, WGPURequestAdapterOptions const* options, WGPURequestAdapterCallback callback, void* userdata);
+void wgpuInstanceProcessEvents(WGPUInstance instance);
+WGPUBool wgpuAdapterHasFeature(WGPUAdapter adapter, WGPUFeatureName feature);
+void wgpuAdapterRequestDevice(WGPUAdapter adapter, WGPUDeviceDescriptor const* descriptor, WGPURequestDeviceCallback callback, void* userdata);
+
+WGPUQueue wgpuDeviceGetQueue(WGPUDevice device);
+WGPUBool wgpuDeviceHasFeature(WGPUDevice device, WGPUFeatureName feature);
+WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice device, WGPUBufferDescriptor const* descriptor);
+WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice device, WGPUShaderModuleDescriptor const* descriptor);
+WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice device, WGPUBindGroupLayoutDescriptor const* descriptor);
+WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice device, WGPUBindGroupDescriptor const* descriptor);
+WGPUPipelineLayout wgpuDeviceCreatePipelineLayout(WGPUDevice device, WGPUPipelineLayoutDescriptor const* descriptor);
+WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice device, WGPUComputePipelineDescriptor const* descriptor);
+WGPUCommandEncoder wgpuDeviceCreateCommandEncoder(WGPUDevice device, WGPUCommandEncoderDescriptor const* descriptor);
+WGPUQuerySet wgpuDeviceCreateQuerySet(WGPUDevice device, WGPUQuerySetDescriptor const* descriptor);
+
+void wgpuQueueSubmit(WGPUQueue queue, size_t commandCount, WGPUCommandBuffer const* commands);
+void wgpuQueueWriteBuffer(WGPUQueue queue, WGPUBuffer buffer, uint64_t bufferOffset, void const* data, size_t size);
+void wgpuQueueOnSubmittedWorkDone(WGPUQueue queue, WGPUQueueWorkDoneCallback callback, void* userdata);
+
+void wgpuBufferMapAsync(WGPUBuffer buffer, WGPUMapModeFlags mode, size_t offset, size_t size, WGPUBufferMapCallback callback, void* userdata);
+void* wgpuBufferGetMappedRange(WGPUBuffer buffer, size_t offset, size_t size);
+void const* wgpuBufferGetConstMappedRange(WGPUBuffer buffer, size_t offset, size_t size);
+void wgpuBufferUnmap(WGPUBuffer buffer);
+uint64_t wgpuBufferGetSize(WGPUBuffer buffer);
+
+WGPUComputePassEncoder wgpuCommandEncoderBeginComputePass(WGPUCommandEncoder encoder, WGPUComputePassDescriptor const* descriptor);
+void wgpuCommandEncoderCopyBufferToBuffer(WGPUCommandEncoder encoder, WGPUBuffer source, uint64_t sourceOffset, WGPUBuffer destination, uint64_t destinationOffset, uint64_t size);
+void wgpuCommandEncoderResolveQuerySet(WGPUCommandEncoder encoder, WGPUQuerySet querySet, uint32_t firstQuery, uint32_t queryCount, WGPUBuffer destination, uint64_t destinationOffset);
+WGPUCommandBuffer wgpuCommandEncoderFinish(WGPUCommandEncoder encoder, WGPUCommandBufferDescriptor const* descriptor);
+
+void wgpuComputePassEncoderSetPipeline(WGPUComputePassEncoder pass, WGPUComputePipeline pipeline);
+void wgpuComputePassEncoderSetBindGroup(WGPUComputePassEncoder pass, uint32_t groupIndex, WGPUBindGroup group, size_t dynamicOffsetCount, uint32_t const* dynamicOffsets);
+void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder pass, uint32_t workgroupCountX, uint32_t workgroupCountY, uint32_t workgroupCountZ);
+void wgpuComputePassEncoderDispatchWorkgroupsIndirect(WGPUComputePassEncoder pass, WGPUBuffer indirectBuffer, uint64_t indirectOffset);
+void wgpuComputePassEncoderEnd(WGPUComputePassEncoder pass);
+
+void wgpuInstanceRelease(WGPUInstance instance);
+void wgpuAdapterRelease(WGPUAdapter adapter);
+void wgpuDeviceRelease(WGPUDevice device);
+void wgpuQueueRelease(WGPUQueue queue);
+void wgpuBufferRelease(WGPUBuffer buffer);
+void wgpuShaderModuleRelease(WGPUShaderModule module);
+void wgpuBindGroupLayoutRelease(WGPUBindGroupLayout layout);
+void wgpuBindGroupRelease(WGPUBindGroup group);
+void wgpuPipelineLayoutRelease(WGPUPipelineLayout layout);
+void wgpuComputePipelineRelease(WGPUComputePipeline pipeline);
+void wgpuCommandEncoderRelease(WGPUCommandEncoder encoder);
+void wgpuComputePassEncoderRelease(WGPUComputePassEncoder pass);
+void wgpuCommandBufferRelease(WGPUCommandBuffer commands);
+void wgpuQuerySetDestroy(WGPUQuerySet querySet);
+void wgpuQuerySetRelease(WGPUQuerySet querySet);
+
+#ifdef __cplusplus
+}
+#endif
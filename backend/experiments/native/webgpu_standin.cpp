@@ -0,0 +1,351 @@
+// CPU stand-in for the WebGPU device used by the native experiment builds.
+//
+// Every handle is a ref-counted host object. Queue writes and buffer copies are
+// executed with memcpy when submitted; compute dispatches are recorded and
+// counted but no shader runs. Adapter/device requests, map requests and
+// submitted-work-done notifications are queued and delivered on the next
+// emscripten_sleep() / wgpuInstanceProcessEvents(), matching the "callbacks
+// only fire when you yield" behaviour of the browser.
+//
+// Timestamp queries read a synthetic GPU clock that submitted commands advance
+// by a fixed cost model (see advance_gpu_clock), so timing code gets stable,
+// non-zero durations. Set NATIVE_WEBGPU_NO_TIMESTAMPS=1 to hide the
+// timestamp-query feature and exercise the fallback paths.
+
+#include <webgpu/webgpu.h>
+#include <emscripten/emscripten.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+struct RefCounted {
+    std::atomic<int> refs{1};
+    virtual ~RefCounted() = default;
+};
+
+template <typename T>
+T* add_ref(T* obj) {
+    if (obj) obj->refs.fetch_add(1);
+    return obj;
+}
+
+template <typename T>
+void release(T* obj) {
+    if (obj && obj->refs.fetch_sub(1) == 1) delete obj;
+}
+
+// --- Deferred callbacks ---
+std::mutex g_pending_mtx;
+std::vector<std::function<void()>> g_pending;
+
+void defer(std::function<void()> fn) {
+    std::lock_guard<std::mutex> lk(g_pending_mtx);
+    g_pending.push_back(std::move(fn));
+}
+
+void pump_events() {
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lk(g_pending_mtx);
+        ready.swap(g_pending);
+    }
+    for (auto& fn : ready) fn();
+}
+
+struct Command {
+    enum Type { Copy, Dispatch, Timestamp, ResolveQuery } type;
+    WGPUBuffer src;
+    WGPUBuffer dst;
+    uint64_t src_offset;
+    uint64_t dst_offset;
+    uint64_t size;                  // Bytes (Copy), workgroups (Dispatch), queries (ResolveQuery)
+    WGPUQuerySet query_set = nullptr;
+    uint32_t query_index = 0;       // Timestamp slot, or first query to resolve
+};
+
+bool timestamps_available() {
+    const char* off = std::getenv("NATIVE_WEBGPU_NO_TIMESTAMPS");
+    return !(off && off[0] && off[0] != '0');
+}
+
+// --- Synthetic GPU Clock ---
+// Nanoseconds; only submitted work moves it. 16 bytes/ns for copies and
+// 4 ns per workgroup for dispatches, plus a fixed per-command cost.
+std::atomic<uint64_t> g_gpu_clock_ns{0};
+
+void advance_gpu_clock(const Command& c) {
+    if (c.type == Command::Copy) g_gpu_clock_ns.fetch_add(200 + c.size / 16);
+    else if (c.type == Command::Dispatch) g_gpu_clock_ns.fetch_add(500 + c.size * 4);
+}
+
+} // namespace
+
+struct WGPUInstanceImpl : RefCounted {};
+struct WGPUAdapterImpl : RefCounted {};
+struct WGPUQueueImpl : RefCounted {};
+struct WGPUDeviceImpl : RefCounted {
+    WGPUQueueImpl* queue = new WGPUQueueImpl();
+    bool timestamp_query = false;
+    ~WGPUDeviceImpl() override { release(queue); }
+};
+
+struct WGPUQuerySetImpl : RefCounted {
+    std::vector<uint64_t> values;
+};
+
+struct WGPUBufferImpl : RefCounted {
+    std::vector<uint8_t> data;
+    WGPUBufferUsageFlags usage = 0;
+    bool mapped = false;
+    bool map_pending = false;
+};
+
+struct WGPUShaderModuleImpl : RefCounted {};
+struct WGPUBindGroupLayoutImpl : RefCounted {};
+struct WGPUBindGroupImpl : RefCounted {};
+struct WGPUPipelineLayoutImpl : RefCounted {};
+struct WGPUComputePipelineImpl : RefCounted {};
+
+struct WGPUCommandBufferImpl : RefCounted {
+    std::vector<Command> commands;
+    ~WGPUCommandBufferImpl() override {
+        for (auto& c : commands) {
+            release(c.src);
+            release(c.dst);
+            release(c.query_set);
+        }
+    }
+};
+
+struct WGPUCommandEncoderImpl : RefCounted {
+    WGPUCommandBufferImpl* recording = new WGPUCommandBufferImpl();
+    ~WGPUCommandEncoderImpl() override { release(recording); }
+};
+
+struct WGPUComputePassEncoderImpl : RefCounted {
+    WGPUCommandEncoderImpl* encoder = nullptr;
+    WGPUQuerySetImpl* timestamps = nullptr;
+    uint32_t end_index = WGPU_QUERY_SET_INDEX_UNDEFINED;
+    ~WGPUComputePassEncoderImpl() override {
+        release(encoder);
+        release(timestamps);
+    }
+};
+
+extern "C" {
+
+// --- Instance / Adapter / Device ---
+WGPUInstance wgpuCreateInstance(WGPUInstanceDescriptor const*) {
+    native_set_event_pump(pump_events);
+    return new WGPUInstanceImpl();
+}
+
+void wgpuInstanceRequestAdapter(WGPUInstance, WGPURequestAdapterOptions const*, WGPURequestAdapterCallback callback, void* userdata) {
+    WGPUAdapter adapter = new WGPUAdapterImpl();
+    defer([=] { callback(WGPURequestAdapterStatus_Success, adapter, nullptr, userdata); });
+}
+
+void wgpuInstanceProcessEvents(WGPUInstance) {
+    pump_events();
+}
+
+WGPUBool wgpuAdapterHasFeature(WGPUAdapter, WGPUFeatureName feature) {
+    return feature == WGPUFeatureName_TimestampQuery && timestamps_available();
+}
+
+void wgpuAdapterRequestDevice(WGPUAdapter adapter, WGPUDeviceDescriptor const* descriptor, WGPURequestDeviceCallback callback, void* userdata) {
+    WGPUDevice device = new WGPUDeviceImpl();
+    for (size_t i = 0; descriptor && i < descriptor->requiredFeatureCount; i++) {
+        if (descriptor->requiredFeatures[i] == WGPUFeatureName_TimestampQuery) {
+            device->timestamp_query = wgpuAdapterHasFeature(adapter, WGPUFeatureName_TimestampQuery) != 0;
+        }
+    }
+    defer([=] { callback(WGPURequestDeviceStatus_Success, device, nullptr, userdata); });
+}
+
+WGPUQueue wgpuDeviceGetQueue(WGPUDevice device) {
+    return add_ref(device->queue);
+}
+
+WGPUBool wgpuDeviceHasFeature(WGPUDevice device, WGPUFeatureName feature) {
+    return feature == WGPUFeatureName_TimestampQuery && device->timestamp_query;
+}
+
+WGPUQuerySet wgpuDeviceCreateQuerySet(WGPUDevice, WGPUQuerySetDescriptor const* descriptor) {
+    WGPUQuerySetImpl* querySet = new WGPUQuerySetImpl();
+    querySet->values.assign(descriptor->count, 0);
+    return querySet;
+}
+
+WGPUBuffer wgpuDeviceCreateBuffer(WGPUDevice, WGPUBufferDescriptor const* descriptor) {
+    WGPUBufferImpl* buffer = new WGPUBufferImpl();
+    buffer->data.assign(descriptor->size, 0);
+    buffer->usage = descriptor->usage;
+    buffer->mapped = descriptor->mappedAtCreation != 0;
+    return buffer;
+}
+
+WGPUShaderModule wgpuDeviceCreateShaderModule(WGPUDevice, WGPUShaderModuleDescriptor const*) {
+    return new WGPUShaderModuleImpl();
+}
+
+WGPUBindGroupLayout wgpuDeviceCreateBindGroupLayout(WGPUDevice, WGPUBindGroupLayoutDescriptor const*) {
+    return new WGPUBindGroupLayoutImpl();
+}
+
+WGPUBindGroup wgpuDeviceCreateBindGroup(WGPUDevice, WGPUBindGroupDescriptor const*) {
+    return new WGPUBindGroupImpl();
+}
+
+WGPUPipelineLayout wgpuDeviceCreatePipelineLayout(WGPUDevice, WGPUPipelineLayoutDescriptor const*) {
+    return new WGPUPipelineLayoutImpl();
+}
+
+WGPUComputePipeline wgpuDeviceCreateComputePipeline(WGPUDevice, WGPUComputePipelineDescriptor const*) {
+    return new WGPUComputePipelineImpl();
+}
+
+WGPUCommandEncoder wgpuDeviceCreateCommandEncoder(WGPUDevice, WGPUCommandEncoderDescriptor const*) {
+    return new WGPUCommandEncoderImpl();
+}
+
+// --- Queue ---
+void wgpuQueueSubmit(WGPUQueue, size_t commandCount, WGPUCommandBuffer const* commands) {
+    for (size_t i = 0; i < commandCount; i++) {
+        for (const Command& c : commands[i]->commands) {
+            advance_gpu_clock(c);
+            if (c.type == Command::Copy) {
+                std::memcpy(c.dst->data.data() + c.dst_offset, c.src->data.data() + c.src_offset, c.size);
+            } else if (c.type == Command::Timestamp) {
+                c.query_set->values[c.query_index] = g_gpu_clock_ns.load();
+            } else if (c.type == Command::ResolveQuery) {
+                std::memcpy(c.dst->data.data() + c.dst_offset, c.query_set->values.data() + c.query_index, c.size * sizeof(uint64_t));
+            }
+        }
+    }
+}
+
+void wgpuQueueWriteBuffer(WGPUQueue, WGPUBuffer buffer, uint64_t bufferOffset, void const* data, size_t size) {
+    std::memcpy(buffer->data.data() + bufferOffset, data, size);
+}
+
+void wgpuQueueOnSubmittedWorkDone(WGPUQueue, WGPUQueueWorkDoneCallback callback, void* userdata) {
+    // Submits execute synchronously, so all prior work is already done
+    defer([=] { callback(WGPUQueueWorkDoneStatus_Success, userdata); });
+}
+
+// --- Buffer ---
+void wgpuBufferMapAsync(WGPUBuffer buffer, WGPUMapModeFlags, size_t, size_t, WGPUBufferMapCallback callback, void* userdata) {
+    // Mapping a buffer that is mapped or has a map pending is a validation error
+    if (buffer->mapped || buffer->map_pending) {
+        defer([=] { callback(WGPUBufferMapAsyncStatus_ValidationError, userdata); });
+        return;
+    }
+    buffer->map_pending = true;
+    add_ref(buffer);
+    defer([=] {
+        buffer->map_pending = false;
+        buffer->mapped = true;
+        callback(WGPUBufferMapAsyncStatus_Success, userdata);
+        release(buffer);
+    });
+}
+
+void* wgpuBufferGetMappedRange(WGPUBuffer buffer, size_t offset, size_t) {
+    return buffer->mapped ? buffer->data.data() + offset : nullptr;
+}
+
+void const* wgpuBufferGetConstMappedRange(WGPUBuffer buffer, size_t offset, size_t size) {
+    return wgpuBufferGetMappedRange(buffer, offset, size);
+}
+
+void wgpuBufferUnmap(WGPUBuffer buffer) {
+    buffer->mapped = false;
+}
+
+uint64_t wgpuBufferGetSize(WGPUBuffer buffer) {
+    return buffer->data.size();
+}
+
+// --- Command encoding ---
+WGPUComputePassEncoder wgpuCommandEncoderBeginComputePass(WGPUCommandEncoder encoder, WGPUComputePassDescriptor const* descriptor) {
+    WGPUComputePassEncoderImpl* pass = new WGPUComputePassEncoderImpl();
+    pass->encoder = add_ref(encoder);
+    const WGPUComputePassTimestampWrites* writes = descriptor ? descriptor->timestampWrites : nullptr;
+    if (writes) {
+        pass->timestamps = add_ref(writes->querySet);
+        pass->end_index = writes->endOfPassWriteIndex;
+        if (writes->beginningOfPassWriteIndex != WGPU_QUERY_SET_INDEX_UNDEFINED) {
+            Command c{Command::Timestamp, nullptr, nullptr, 0, 0, 0};
+            c.query_set = add_ref(writes->querySet);
+            c.query_index = writes->beginningOfPassWriteIndex;
+            encoder->recording->commands.push_back(c);
+        }
+    }
+    return pass;
+}
+
+void wgpuCommandEncoderCopyBufferToBuffer(WGPUCommandEncoder encoder, WGPUBuffer source, uint64_t sourceOffset, WGPUBuffer destination, uint64_t destinationOffset, uint64_t size) {
+    encoder->recording->commands.push_back(Command{Command::Copy, add_ref(source), add_ref(destination), sourceOffset, destinationOffset, size});
+}
+
+void wgpuCommandEncoderResolveQuerySet(WGPUCommandEncoder encoder, WGPUQuerySet querySet, uint32_t firstQuery, uint32_t queryCount, WGPUBuffer destination, uint64_t destinationOffset) {
+    Command c{Command::ResolveQuery, nullptr, add_ref(destination), 0, destinationOffset, queryCount};
+    c.query_set = add_ref(querySet);
+    c.query_index = firstQuery;
+    encoder->recording->commands.push_back(c);
+}
+
+WGPUCommandBuffer wgpuCommandEncoderFinish(WGPUCommandEncoder encoder, WGPUCommandBufferDescriptor const*) {
+    WGPUCommandBufferImpl* commands = encoder->recording;
+    encoder->recording = new WGPUCommandBufferImpl();
+    return commands;
+}
+
+void wgpuComputePassEncoderSetPipeline(WGPUComputePassEncoder, WGPUComputePipeline) {}
+
+void wgpuComputePassEncoderSetBindGroup(WGPUComputePassEncoder, uint32_t, WGPUBindGroup, size_t, uint32_t const*) {}
+
+void wgpuComputePassEncoderDispatchWorkgroups(WGPUComputePassEncoder pass, uint32_t x, uint32_t y, uint32_t z) {
+    pass->encoder->recording->commands.push_back(Command{Command::Dispatch, nullptr, nullptr, 0, 0, (uint64_t)x * y * z});
+}
+
+void wgpuComputePassEncoderDispatchWorkgroupsIndirect(WGPUComputePassEncoder pass, WGPUBuffer indirectBuffer, uint64_t indirectOffset) {
+    // The workgroup counts are read by the GPU at execution time; only the
+    // args buffer is recorded
+    pass->encoder->recording->commands.push_back(Command{Command::Dispatch, add_ref(indirectBuffer), nullptr, indirectOffset, 0, 0});
+}
+
+void wgpuComputePassEncoderEnd(WGPUComputePassEncoder pass) {
+    if (pass->timestamps && pass->end_index != WGPU_QUERY_SET_INDEX_UNDEFINED) {
+        Command c{Command::Timestamp, nullptr, nullptr, 0, 0, 0};
+        c.query_set = add_ref(pass->timestamps);
+        c.query_index = pass->end_index;
+        pass->encoder->recording->commands.push_back(c);
+    }
+}
+
+// --- Release ---
+void wgpuInstanceRelease(WGPUInstance instance) { release(instance); }
+void wgpuAdapterRelease(WGPUAdapter adapter) { release(adapter); }
+void wgpuDeviceRelease(WGPUDevice device) { release(device); }
+void wgpuQueueRelease(WGPUQueue queue) { release(queue); }
+void wgpuBufferRelease(WGPUBuffer buffer) { release(buffer); }
+void wgpuShaderModuleRelease(WGPUShaderModule module) { release(module); }
+void wgpuBindGroupLayoutRelease(WGPUBindGroupLayout layout) { release(layout); }
+void wgpuBindGroupRelease(WGPUBindGroup group) { release(group); }
+void wgpuPipelineLayoutRelease(WGPUPipelineLayout layout) { release(layout); }
+void wgpuComputePipelineRelease(WGPUComputePipeline pipeline) { release(pipeline); }
+void wgpuCommandEncoderRelease(WGPUCommandEncoder encoder) { release(encoder); }
+void wgpuComputePassEncoderRelease(WGPUComputePassEncoder pass) { release(pass); }
+void wgpuCommandBufferRelease(WGPUCommandBuffer commands) { release(commands); }
+void wgpuQuerySetDestroy(WGPUQuerySet) {}
+void wgpuQuerySetRelease(WGPUQuerySet querySet) { release(querySet); }
+
+} // extern "C"
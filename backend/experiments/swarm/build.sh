@@ -33,6 +33,7 @@ emcc swarm.cpp -o "$OUT_DIR/swarm.js" \
   -L"$PUBLIC_DIR" \
   -fopenmp \
   -lomp \
+  -msimd128 \
   -std=c++17 \
   -O3 --bind
 
@@ -6,101 +6,1629 @@
 #include <thread>
 #include <mutex>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <cstdlib>
+#include <new>
+#include <cstring>
+#include <string>
+#include <cstdio>
+#include <map>
+#include <sstream>
+#include <fstream>
+
+#include "../common/alloc_tracker.h"
+#include "../common/bench_harness.h"
+#include "../common/radix_sort.h"
+#include "../common/thread_pool.h"
+#include "../common/trace.h"
 
 // Include OpenMP header if compiled with -fopenmp
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+// Pick the widest SIMD instruction set the compiler was told to target
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define SWARM_SIMD_WIDTH 4
+#elif defined(__AVX__)
+#include <immintrin.h>
+#define SWARM_SIMD_WIDTH 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SWARM_SIMD_WIDTH 4
+#else
+#define SWARM_SIMD_WIDTH 0
+#endif
+
 using namespace emscripten;
 
-struct Boid {
-    float x, y;
-    float vx, vy;
-    float ax, ay;
+// --- Aligned Storage ---
+// 32-byte alignment covers both 128-bit (SSE/SIMD128) and 256-bit (AVX) loads
+template <typename T, size_t Align>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = (n * sizeof(T) + Align - 1) / Align * Align;
+        void* p = std::aligned_alloc(Align, bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+    void deallocate(T* p, size_t) { std::free(p); }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Align>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Align>&) const { return false; }
+};
+
+using AlignedFloats = std::vector<float, AlignedAllocator<float, 32>>;
+
+// Structure-of-Arrays boid store: each component is contiguous so the
+// integration pass can load SWARM_SIMD_WIDTH boids per instruction.
+struct BoidSoA {
+    AlignedFloats x, y;
+    AlignedFloats vx, vy;
+    AlignedFloats ax, ay;
+
+    size_t size() const { return x.size(); }
+
+    void resize(size_t n) {
+        x.resize(n); y.resize(n);
+        vx.resize(n); vy.resize(n);
+        ax.resize(n); ay.resize(n);
+    }
 };
 
-// Global simulation state
-std::vector<Boid> boids;
+// Global simulation state. `boids` is the current state; `boids_next` is the
+// integration target (see Double-Buffered State).
+BoidSoA boids;
+BoidSoA boids_next;
 const int NUM_BOIDS = 2000;
 const float WIDTH = 800.0f;
 const float HEIGHT = 600.0f;
 
+// --- Flocking Parameters ---
+const float PERCEPTION_RADIUS = 25.0f;
+const float SEPARATION_RADIUS = 10.0f;
+const float SEPARATION_WEIGHT = 1.5f;
+const float ALIGNMENT_WEIGHT = 1.0f;
+const float COHESION_WEIGHT = 1.0f;
+const float MAX_SPEED = 4.0f;
+
+// Neighbour search strategy used by the force pass
+enum NeighborMode {
+    NEIGHBOR_GRID = 0,        // Spatial hash grid, O(N*k)
+    NEIGHBOR_BRUTE_FORCE = 1  // Reference all-pairs scan, O(N^2)
+};
+int neighbor_mode = NEIGHBOR_GRID;
+
+// Integration kernel A/B switch (ignored when SWARM_SIMD_WIDTH == 0)
+bool simd_enabled = true;
+
 // --- Helper Math ---
-float dist_sq(const Boid& a, const Boid& b) {
-    float dx = a.x - b.x;
-    float dy = a.y - b.y;
+float dist_sq(const BoidSoA& b, int i, int j) {
+    float dx = b.x[i] - b.x[j];
+    float dy = b.y[i] - b.y[j];
     return dx*dx + dy*dy;
 }
 
-// Initialize
-void init_boids(int count) {
-    boids.resize(count);
-    for(int i=0; i<count; i++) {
-        boids[i].x = (float)(rand() % (int)WIDTH);
-        boids[i].y = (float)(rand() % (int)HEIGHT);
-        // Cast RAND_MAX to float to fix warning
-        boids[i].vx = ((float)rand()/(float)RAND_MAX - 0.5f) * 4.0f;
-        boids[i].vy = ((float)rand()/(float)RAND_MAX - 0.5f) * 4.0f;
-        boids[i].ax = 0;
-        boids[i].ay = 0;
+// --- Spatial Hash Grid ---
+// Uniform grid with PERCEPTION_RADIUS-sized cells, so every neighbour of a boid
+// lives in the 3x3 block around its own cell. Rebuilt each step with a counting
+// sort: after rebuild(), the boids of cell c are sorted[cell_start[c] .. cell_start[c+1]).
+struct SpatialGrid {
+    int cols = 0;
+    int rows = 0;
+    float inv_cell = 0.0f;
+    std::vector<int> cell_start; // Exclusive prefix sum of per-cell counts (cols*rows + 1)
+    std::vector<int> cell_of;    // Cell index of each boid
+    std::vector<int> sorted;     // Boid indices ordered by cell
+
+    int cell_x(float x) const {
+        return std::min(cols - 1, std::max(0, (int)(x * inv_cell)));
+    }
+
+    int cell_y(float y) const {
+        return std::min(rows - 1, std::max(0, (int)(y * inv_cell)));
+    }
+
+    void rebuild(const BoidSoA& b) {
+        cols = std::max(1, (int)std::ceil(WIDTH / PERCEPTION_RADIUS));
+        rows = std::max(1, (int)std::ceil(HEIGHT / PERCEPTION_RADIUS));
+        inv_cell = 1.0f / PERCEPTION_RADIUS;
+
+        const int n = (int)b.size();
+        cell_start.assign(cols * rows + 1, 0);
+        cell_of.resize(n);
+        sorted.resize(n);
+
+        // 1. Histogram
+        for (int i = 0; i < n; i++) {
+            int c = cell_y(b.y[i]) * cols + cell_x(b.x[i]);
+            cell_of[i] = c;
+            cell_start[c + 1]++;
+        }
+        // 2. Prefix sum -> start offset of every cell
+        for (int c = 0; c < cols * rows; c++) {
+            cell_start[c + 1] += cell_start[c];
+        }
+        // 3. Scatter (stable, so each cell keeps ascending boid order)
+        std::vector<int>& cursor = scatter_cursor;
+        cursor.assign(cell_start.begin(), cell_start.end() - 1);
+        for (int i = 0; i < n; i++) {
+            sorted[cursor[cell_of[i]]++] = i;
+        }
+    }
+
+private:
+    std::vector<int> scatter_cursor;
+};
+
+SpatialGrid grid;
+
+// --- Flocking Forces ---
+// Running sums for the three classic rules over one boid's neighbourhood
+struct FlockAccum {
+    float sep_x = 0, sep_y = 0;
+    float vel_x = 0, vel_y = 0;
+    float pos_x = 0, pos_y = 0;
+    int count = 0;
+};
+
+inline void accumulate_neighbor(FlockAccum& acc, int self, int other) {
+    float d2 = dist_sq(boids, self, other);
+    if (d2 >= PERCEPTION_RADIUS * PERCEPTION_RADIUS || d2 == 0.0f) return;
+
+    acc.vel_x += boids.vx[other];
+    acc.vel_y += boids.vy[other];
+    acc.pos_x += boids.x[other];
+    acc.pos_y += boids.y[other];
+    acc.count++;
+
+    if (d2 < SEPARATION_RADIUS * SEPARATION_RADIUS) {
+        // Push away, weighted by 1/d so close contacts dominate
+        acc.sep_x += (boids.x[self] - boids.x[other]) / d2;
+        acc.sep_y += (boids.y[self] - boids.y[other]) / d2;
+    }
+}
+
+inline void apply_flock_rules(int i, const FlockAccum& acc) {
+    if (acc.count == 0) {
+        boids.ax[i] = 0;
+        boids.ay[i] = 0;
+        return;
+    }
+    float inv = 1.0f / (float)acc.count;
+    float align_x = acc.vel_x * inv - boids.vx[i];
+    float align_y = acc.vel_y * inv - boids.vy[i];
+    float coh_x = (acc.pos_x * inv - boids.x[i]) / PERCEPTION_RADIUS;
+    float coh_y = (acc.pos_y * inv - boids.y[i]) / PERCEPTION_RADIUS;
+
+    boids.ax[i] = SEPARATION_WEIGHT * acc.sep_x + ALIGNMENT_WEIGHT * align_x + COHESION_WEIGHT * coh_x;
+    boids.ay[i] = SEPARATION_WEIGHT * acc.sep_y + ALIGNMENT_WEIGHT * align_y + COHESION_WEIGHT * coh_y;
+}
+
+// Reference: scan every other boid
+void compute_force_brute(int i) {
+    FlockAccum acc;
+    for (int j = 0; j < (int)boids.size(); j++) {
+        if (j != i) accumulate_neighbor(acc, i, j);
+    }
+    apply_flock_rules(i, acc);
+}
+
+// Grid: only the 3x3 cells around the boid
+void compute_force_grid(int i) {
+    FlockAccum acc;
+    int cx = grid.cell_x(boids.x[i]);
+    int cy = grid.cell_y(boids.y[i]);
+    for (int y = std::max(0, cy - 1); y <= std::min(grid.rows - 1, cy + 1); y++) {
+        for (int x = std::max(0, cx - 1); x <= std::min(grid.cols - 1, cx + 1); x++) {
+            int c = y * grid.cols + x;
+            for (int k = grid.cell_start[c]; k < grid.cell_start[c + 1]; k++) {
+                int j = grid.sorted[k];
+                if (j != i) accumulate_neighbor(acc, i, j);
+            }
+        }
+    }
+    apply_flock_rules(i, acc);
+}
+
+// Phase 1: read neighbour positions/velocities, write only this boid's ax/ay.
+// Nobody writes x/y/vx/vy during this phase, so threads never race.
+void compute_forces_range(int start, int end) {
+    if (neighbor_mode == NEIGHBOR_BRUTE_FORCE) {
+        for (int i = start; i < end; i++) compute_force_brute(i);
+    } else {
+        for (int i = start; i < end; i++) compute_force_grid(i);
     }
 }
 
-// --- OPTION A: Manual Pthreads (std::thread) ---
-// This splits the work manually into chunks
-void worker_thread_func(int start, int end, float dt) {
+// Phase 2: integrate and bounce, reading `boids` and writing x/y/vx/vy of
+// `boids_next`
+// Scalar reference. Same operation order as the SIMD kernel so both produce
+// bit-identical results.
+void integrate_range_scalar(int start, int end, float dt) {
     for (int i = start; i < end; i++) {
-        // Simple flocking logic placeholders
-        boids[i].x += boids[i].vx * dt;
-        boids[i].y += boids[i].vy * dt;
-        
+        float vx = boids.vx[i] + boids.ax[i] * dt;
+        float vy = boids.vy[i] + boids.ay[i] * dt;
+
+        float speed_sq = vx * vx + vy * vy;
+        if (speed_sq > MAX_SPEED * MAX_SPEED) {
+            float scale = MAX_SPEED / std::sqrt(speed_sq);
+            vx *= scale;
+            vy *= scale;
+        }
+
+        float x = boids.x[i] + vx * dt;
+        float y = boids.y[i] + vy * dt;
+
         // Bounce off walls
-        if(boids[i].x < 0 || boids[i].x > WIDTH) boids[i].vx *= -1;
-        if(boids[i].y < 0 || boids[i].y > HEIGHT) boids[i].vy *= -1;
+        if(x < 0 || x > WIDTH) vx *= -1;
+        if(y < 0 || y > HEIGHT) vy *= -1;
+
+        boids_next.x[i] = x; boids_next.y[i] = y;
+        boids_next.vx[i] = vx; boids_next.vy[i] = vy;
     }
 }
 
-void update_boids(float dt) {
-    int num_threads = 4; // Or std::thread::hardware_concurrency()
-    std::vector<std::thread> threads;
-    int chunk = boids.size() / num_threads;
+#if SWARM_SIMD_WIDTH > 0
+// --- SIMD Primitives ---
+#if defined(__wasm_simd128__)
+typedef v128_t simd_f;
+inline simd_f simd_load(const float* p) { return wasm_v128_load(p); }
+inline void simd_store(float* p, simd_f v) { wasm_v128_store(p, v); }
+inline simd_f simd_set1(float v) { return wasm_f32x4_splat(v); }
+inline simd_f simd_add(simd_f a, simd_f b) { return wasm_f32x4_add(a, b); }
+inline simd_f simd_mul(simd_f a, simd_f b) { return wasm_f32x4_mul(a, b); }
+inline simd_f simd_div(simd_f a, simd_f b) { return wasm_f32x4_div(a, b); }
+inline simd_f simd_sqrt(simd_f a) { return wasm_f32x4_sqrt(a); }
+inline simd_f simd_lt(simd_f a, simd_f b) { return wasm_f32x4_lt(a, b); }
+inline simd_f simd_gt(simd_f a, simd_f b) { return wasm_f32x4_gt(a, b); }
+inline simd_f simd_or(simd_f a, simd_f b) { return wasm_v128_or(a, b); }
+inline simd_f simd_and(simd_f a, simd_f b) { return wasm_v128_and(a, b); }
+inline simd_f simd_xor(simd_f a, simd_f b) { return wasm_v128_xor(a, b); }
+inline simd_f simd_select(simd_f mask, simd_f a, simd_f b) { return wasm_v128_bitselect(a, b, mask); }
+#elif defined(__AVX__)
+typedef __m256 simd_f;
+inline simd_f simd_load(const float* p) { return _mm256_loadu_ps(p); }
+inline void simd_store(float* p, simd_f v) { _mm256_storeu_ps(p, v); }
+inline simd_f simd_set1(float v) { return _mm256_set1_ps(v); }
+inline simd_f simd_add(simd_f a, simd_f b) { return _mm256_add_ps(a, b); }
+inline simd_f simd_mul(simd_f a, simd_f b) { return _mm256_mul_ps(a, b); }
+inline simd_f simd_div(simd_f a, simd_f b) { return _mm256_div_ps(a, b); }
+inline simd_f simd_sqrt(simd_f a) { return _mm256_sqrt_ps(a); }
+inline simd_f simd_lt(simd_f a, simd_f b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline simd_f simd_gt(simd_f a, simd_f b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+inline simd_f simd_or(simd_f a, simd_f b) { return _mm256_or_ps(a, b); }
+inline simd_f simd_and(simd_f a, simd_f b) { return _mm256_and_ps(a, b); }
+inline simd_f simd_xor(simd_f a, simd_f b) { return _mm256_xor_ps(a, b); }
+inline simd_f simd_select(simd_f mask, simd_f a, simd_f b) { return _mm256_blendv_ps(b, a, mask); }
+#else // SSE2
+typedef __m128 simd_f;
+inline simd_f simd_load(const float* p) { return _mm_loadu_ps(p); }
+inline void simd_store(float* p, simd_f v) { _mm_storeu_ps(p, v); }
+inline simd_f simd_set1(float v) { return _mm_set1_ps(v); }
+inline simd_f simd_add(simd_f a, simd_f b) { return _mm_add_ps(a, b); }
+inline simd_f simd_mul(simd_f a, simd_f b) { return _mm_mul_ps(a, b); }
+inline simd_f simd_div(simd_f a, simd_f b) { return _mm_div_ps(a, b); }
+inline simd_f simd_sqrt(simd_f a) { return _mm_sqrt_ps(a); }
+inline simd_f simd_lt(simd_f a, simd_f b) { return _mm_cmplt_ps(a, b); }
+inline simd_f simd_gt(simd_f a, simd_f b) { return _mm_cmpgt_ps(a, b); }
+inline simd_f simd_or(simd_f a, simd_f b) { return _mm_or_ps(a, b); }
+inline simd_f simd_and(simd_f a, simd_f b) { return _mm_and_ps(a, b); }
+inline simd_f simd_xor(simd_f a, simd_f b) { return _mm_xor_ps(a, b); }
+inline simd_f simd_select(simd_f mask, simd_f a, simd_f b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#endif
+
+// SWARM_SIMD_WIDTH boids per iteration. Speed clamp and wall bounce are
+// branchless: compute both outcomes and pick per lane with a mask.
+void integrate_range_simd(int start, int end, float dt) {
+    const simd_f v_dt = simd_set1(dt);
+    const simd_f v_max_speed = simd_set1(MAX_SPEED);
+    const simd_f v_max_speed_sq = simd_set1(MAX_SPEED * MAX_SPEED);
+    const simd_f v_one = simd_set1(1.0f);
+    const simd_f v_zero = simd_set1(0.0f);
+    const simd_f v_width = simd_set1(WIDTH);
+    const simd_f v_height = simd_set1(HEIGHT);
+    const simd_f v_sign = simd_set1(-0.0f);
+
+    int i = start;
+    for (; i + SWARM_SIMD_WIDTH <= end; i += SWARM_SIMD_WIDTH) {
+        simd_f vx = simd_add(simd_load(&boids.vx[i]), simd_mul(simd_load(&boids.ax[i]), v_dt));
+        simd_f vy = simd_add(simd_load(&boids.vy[i]), simd_mul(simd_load(&boids.ay[i]), v_dt));
+
+        simd_f speed_sq = simd_add(simd_mul(vx, vx), simd_mul(vy, vy));
+        simd_f too_fast = simd_gt(speed_sq, v_max_speed_sq);
+        simd_f scale = simd_select(too_fast, simd_div(v_max_speed, simd_sqrt(speed_sq)), v_one);
+        vx = simd_mul(vx, scale);
+        vy = simd_mul(vy, scale);
+
+        simd_f x = simd_add(simd_load(&boids.x[i]), simd_mul(vx, v_dt));
+        simd_f y = simd_add(simd_load(&boids.y[i]), simd_mul(vy, v_dt));
+
+        // Bounce: flip the velocity sign bit in lanes that left the world
+        simd_f out_x = simd_or(simd_lt(x, v_zero), simd_gt(x, v_width));
+        simd_f out_y = simd_or(simd_lt(y, v_zero), simd_gt(y, v_height));
+        vx = simd_xor(vx, simd_and(out_x, v_sign));
+        vy = simd_xor(vy, simd_and(out_y, v_sign));
+
+        simd_store(&boids_next.x[i], x);
+        simd_store(&boids_next.y[i], y);
+        simd_store(&boids_next.vx[i], vx);
+        simd_store(&boids_next.vy[i], vy);
+    }
+    // Tail
+    integrate_range_scalar(i, end, dt);
+}
+#endif
+
+void integrate_range(int start, int end, float dt) {
+#if SWARM_SIMD_WIDTH > 0
+    if (simd_enabled) {
+        integrate_range_simd(start, end, dt);
+        return;
+    }
+#endif
+    integrate_range_scalar(start, end, dt);
+}
+
+void prepare_neighbor_search() {
+    TRACE_SCOPE("grid-rebuild");
+    if (neighbor_mode == NEIGHBOR_GRID) grid.rebuild(boids);
+}
+
+// --- Double-Buffered State ---
+// A step reads one state and writes the next. The force pass reads positions
+// and velocities from `boids` and writes only each boid's own ax/ay; the
+// integration pass reads `boids` and writes `boids_next`; then the buffers
+// swap. No pass writes anything another thread of the same pass reads, so
+// results are independent of thread count and scheduling, and each pass can be
+// rerun on its own (see benchmark_step_phases). Accelerations are per-step
+// scratch and stay in `boids`.
+void swap_state_buffers() {
+    boids.x.swap(boids_next.x);
+    boids.y.swap(boids_next.y);
+    boids.vx.swap(boids_next.vx);
+    boids.vy.swap(boids_next.vy);
+}
+
+// --- Spatial Reordering (Morton Order) ---
+// As boids move, spatial neighbours drift apart in the arrays, so the grid's
+// neighbour loop gathers from all over memory (and threads share cache lines).
+// Every `reorder_interval` steps the boids are sorted by the Z-order (Morton)
+// key of their position, using the parallel radix sort in common/radix_sort.h,
+// so boids close in space sit close in memory. Slots move, handles don't:
+// boid_order maps each boid's stable handle (its index at init) to its current
+// slot and back, and the position export is written in handle order.
+// Reordering changes the neighbour summation order, so checksums only match
+// between update paths run at the same interval.
+const int MORTON_COORD_BITS = 16;
+const int REORDER_DEFAULT_INTERVAL = 10; // Used by benchmark_reorder when reordering is off
+
+struct BoidOrder {
+    std::vector<uint32_t> handle_of; // Slot -> handle
+    std::vector<uint32_t> slot_of;   // Handle -> slot
+    int steps = 0;                   // Steps since init, for the interval
+    bool identity = true;
+
+    void reset(size_t n) {
+        handle_of.resize(n);
+        slot_of.resize(n);
+        for (size_t i = 0; i < n; i++) handle_of[i] = slot_of[i] = (uint32_t)i;
+        steps = 0;
+        identity = true;
+    }
+};
 
-    for(int t=0; t<num_threads; t++) {
-        int start = t * chunk;
-        int end = (t == num_threads - 1) ? boids.size() : (t + 1) * chunk;
-        threads.emplace_back(worker_thread_func, start, end, dt);
+BoidOrder boid_order;
+int reorder_interval = 0; // Steps between reorders, 0 = never
+
+// Reused across reorders so a reorder allocates nothing once warm
+struct ReorderScratch {
+    std::vector<uint32_t> keys, perm, tmpKeys, tmpVals;
+    std::vector<uint32_t> radixOffsets; // Per-block digit table, blocks * RADIX_BUCKETS
+    BoidSoA sorted;
+};
+ReorderScratch reorder_scratch;
+
+// Spreads the low 16 bits of v to the even bit positions
+inline uint32_t morton_spread(uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+inline uint32_t morton_key(float x, float y) {
+    const float scale = (float)((1 << MORTON_COORD_BITS) - 1);
+    uint32_t qx = (uint32_t)std::min(scale, std::max(0.0f, x * (scale / WIDTH)));
+    uint32_t qy = (uint32_t)std::min(scale, std::max(0.0f, y * (scale / HEIGHT)));
+    return morton_spread(qx) | (morton_spread(qy) << 1);
+}
+
+// Sorts the boids into Morton order now and updates the handle tables
+void reorder_boids() {
+    TRACE_SCOPE("reorder");
+    const size_t n = boids.size();
+    ReorderScratch& s = reorder_scratch;
+    ThreadPool& pool = ThreadPool::instance();
+    s.keys.resize(n);
+    s.perm.resize(n);
+    pool.parallel_for(0, n, 4096, [&s](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            s.keys[i] = morton_key(boids.x[i], boids.y[i]);
+            s.perm[i] = (uint32_t)i;
+        }
+    });
+    radix_sort_pairs(s.keys, s.perm, s.tmpKeys, s.tmpVals, s.radixOffsets, 2 * MORTON_COORD_BITS);
+
+    // Slot i now holds the boid from slot perm[i]
+    s.sorted.resize(n);
+    pool.parallel_for(0, n, 4096, [&s](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t src = s.perm[i];
+            s.sorted.x[i] = boids.x[src];
+            s.sorted.y[i] = boids.y[src];
+            s.sorted.vx[i] = boids.vx[src];
+            s.sorted.vy[i] = boids.vy[src];
+            s.sorted.ax[i] = boids.ax[src];
+            s.sorted.ay[i] = boids.ay[src];
+        }
+    });
+    std::swap(boids, s.sorted);
+
+    std::vector<uint32_t>& oldHandles = s.tmpKeys;
+    oldHandles.assign(boid_order.handle_of.begin(), boid_order.handle_of.end());
+    for (size_t i = 0; i < n; i++) {
+        uint32_t handle = oldHandles[s.perm[i]];
+        boid_order.handle_of[i] = handle;
+        boid_order.slot_of[handle] = (uint32_t)i;
+    }
+    boid_order.identity = false;
+}
+
+void set_reorder_interval(int steps) {
+    reorder_interval = std::max(0, steps);
+}
+
+int get_reorder_interval() {
+    return reorder_interval;
+}
+
+// Current slot of the boid with stable handle `handle` (-1 if out of range)
+int get_boid_slot(int handle) {
+    if (handle < 0 || handle >= (int)boid_order.slot_of.size()) return -1;
+    return (int)boid_order.slot_of[handle];
+}
+
+// Start of every simulation step on every update path: reorder when due, size
+// the integration target, then rebuild the neighbour grid
+void begin_step() {
+    if (reorder_interval > 0 && boid_order.steps % reorder_interval == 0) reorder_boids();
+    boid_order.steps++;
+    boids_next.resize(boids.size()); // No-op unless the state was replaced
+    prepare_neighbor_search();
+}
+
+// --- Render Export (Triple-Buffered Positions) ---
+// Three interleaved [x0, y0, x1, y1, ...] buffers in WASM memory. The simulation
+// fills its private back buffer and publishes it by swapping it into the shared
+// "ready" slot; the renderer swaps its front buffer with "ready" only when a new
+// frame is flagged. The two sides only ever exchange an index through one
+// atomic, so neither blocks and nothing is copied across the JS boundary: JS
+// builds one Float32Array view per buffer once and reads them in place.
+class PositionTripleBuffer {
+public:
+    static constexpr uint32_t kIndexMask = 0x3;
+    static constexpr uint32_t kNewFrame = 0x4;
+
+    // Not safe against a concurrent reader; call before rendering starts.
+    void resize(size_t count) {
+        for (auto& b : buffers) b.assign(count * 2, 0.0f);
+        back = 0;
+        ready.store(1);
+        front = 2;
+        for (auto& f : frame_ids) f = 0;
+        published = 0;
+    }
+
+    size_t floats() const { return buffers[0].size(); }
+    float* data(int index) { return buffers[index].data(); }
+
+    // Writer side. With `handle_of`, slot i is written at its handle's
+    // position, so the renderer's indices stay stable across reorders.
+    void publish(const BoidSoA& b, const uint32_t* handle_of = nullptr) {
+        float* out = buffers[back].data();
+        size_t n = std::min(b.size(), buffers[back].size() / 2);
+        for (size_t i = 0; i < n; i++) {
+            size_t h = handle_of ? handle_of[i] : i;
+            out[2 * h] = b.x[i];
+            out[2 * h + 1] = b.y[i];
+        }
+        frame_ids[back] = ++published;
+        back = ready.exchange(back | kNewFrame, std::memory_order_acq_rel) & kIndexMask;
+    }
+
+    // Reader side: returns the index of the newest complete buffer
+    int acquire() {
+        if (ready.load(std::memory_order_acquire) & kNewFrame) {
+            front = ready.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        }
+        return front;
+    }
+
+    // Simulation step that produced buffer `index`
+    uint32_t frame_id(int index) const { return frame_ids[index]; }
+
+private:
+    AlignedFloats buffers[3];
+    uint32_t frame_ids[3] = {0, 0, 0};
+    uint32_t published = 0;       // Writer-only
+    int back = 0;                 // Writer-only
+    int front = 2;                // Reader-only
+    std::atomic<uint32_t> ready{1};
+};
+
+PositionTripleBuffer render_positions;
+bool position_export_enabled = false;
+
+void publish_positions() {
+    if (position_export_enabled) render_positions.publish(boids, boid_order.identity ? nullptr : boid_order.handle_of.data());
+}
+
+// Call once (after init_boids) before reading positions from JS
+void enable_position_export(bool enabled) {
+    position_export_enabled = enabled;
+    if (enabled) {
+        render_positions.resize(boids.size());
+        publish_positions();
+    }
+}
+
+// Renderer: swap in the latest published frame, returns buffer index 0..2
+int acquire_positions() {
+    return render_positions.acquire();
+}
+
+// Simulation step of the frame held in buffer `index`
+int get_positions_frame(int index) {
+    if (index < 0 || index > 2) return -1;
+    return (int)render_positions.frame_id(index);
+}
+
+// Zero-copy Float32Array over buffer `index` (x/y interleaved). Addresses are
+// stable until the next init_boids/enable_position_export.
+val get_positions_view(int index) {
+    index = std::min(2, std::max(0, index));
+    return val(typed_memory_view(render_positions.floats(), render_positions.data(index)));
+}
+
+// Same buffer as a byte offset into the WASM heap, for `new Float32Array(HEAPF32.buffer, ptr, 2 * n)`
+uintptr_t get_positions_ptr(int index) {
+    index = std::min(2, std::max(0, index));
+    return reinterpret_cast<uintptr_t>(render_positions.data(index));
+}
+
+// Defined with the OpenMP autotuner below: switches to the tuned policy for
+// this boid count, if there is one
+void select_tuned_openmp_policy(int count);
+
+// --- Deterministic Initialisation ---
+// Counter-based RNG: every random value is a pure function of (seed, boid
+// index, field), so any thread can generate any boid independently and every
+// backend (pthreads, OpenMP, SIMD, a future GPU port) starts from the same state.
+const uint32_t DEFAULT_SEED = 0x5EED;
+
+// SplitMix64 finaliser (Steele et al.), a bijective 64-bit mixer
+inline uint64_t splitmix64(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform float in [0, 1) for (seed, index, field)
+inline float counter_uniform(uint32_t seed, uint32_t index, uint32_t field) {
+    uint64_t h = splitmix64(splitmix64(((uint64_t)seed << 32) | field) ^ index);
+    return (float)(h >> 40) * (1.0f / 16777216.0f); // Top 24 bits
+}
+
+// Initialize
+void init_boids_seeded(int count, uint32_t seed) {
+    boids.resize(count);
+    #pragma omp parallel for schedule(static)
+    for(int i=0; i<count; i++) {
+        boids.x[i] = counter_uniform(seed, i, 0) * WIDTH;
+        boids.y[i] = counter_uniform(seed, i, 1) * HEIGHT;
+        boids.vx[i] = (counter_uniform(seed, i, 2) - 0.5f) * 4.0f;
+        boids.vy[i] = (counter_uniform(seed, i, 3) - 0.5f) * 4.0f;
+        boids.ax[i] = 0;
+        boids.ay[i] = 0;
     }
+    boids_next.resize(count);
+    boid_order.reset(count);
+    select_tuned_openmp_policy(count);
+    if (position_export_enabled) enable_position_export(true);
+}
+
+void init_boids(int count) {
+    init_boids_seeded(count, DEFAULT_SEED);
+}
 
-    for(auto& t : threads) {
-        t.join();
+// --- State Checksum ---
+// Sum (mod 2^64) of a per-boid hash of the exact position + velocity bits.
+// Addition commutes, so the result doesn't depend on boid order or on how
+// threads split the sum. Paths that are meant to be bitwise identical (pool vs
+// OpenMP vs batched stepping, scalar vs SIMD integration, any thread count)
+// must produce the same checksum. Grid vs brute-force neighbours differ in float
+// summation order, so compare those with validate_neighbor_grid() instead.
+inline uint64_t hash_float(float v) {
+    if (v == 0.0f) v = 0.0f; // Fold -0 into +0
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return splitmix64(bits);
+}
+
+uint64_t compute_checksum() {
+    uint64_t sum = 0;
+    const int n = (int)boids.size();
+    #pragma omp parallel for schedule(static) reduction(+:sum)
+    for (int i = 0; i < n; i++) {
+        uint64_t h = hash_float(boids.x[i]);
+        h = splitmix64(h ^ hash_float(boids.y[i]));
+        h = splitmix64(h ^ hash_float(boids.vx[i]));
+        h = splitmix64(h ^ hash_float(boids.vy[i]));
+        sum += h;
     }
+    return sum;
+}
+
+// Hex string, since a 64-bit value doesn't survive the trip to a JS number
+std::string swarm_checksum() {
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)compute_checksum());
+    return buf;
+}
+
+
+void set_neighbor_mode(int mode) {
+    neighbor_mode = (mode == NEIGHBOR_BRUTE_FORCE) ? NEIGHBOR_BRUTE_FORCE : NEIGHBOR_GRID;
+}
+
+int get_neighbor_mode() {
+    return neighbor_mode;
+}
+
+void set_simd_enabled(bool enabled) {
+    simd_enabled = enabled;
+}
+
+bool get_simd_enabled() {
+    return simd_enabled && SWARM_SIMD_WIDTH > 0;
+}
+
+// Boids per SIMD instruction in this build (0 = scalar-only build)
+int get_simd_width() {
+    return SWARM_SIMD_WIDTH;
+}
+
+// --- OPTION A: Persistent Thread Pool (std::thread) ---
+// Work-stealing pool from common/thread_pool.h: threads are spawned once and
+// reused, so each phase is a submit-and-wait rather than 4 spawns + joins.
+template <typename Fn>
+void run_on_threads(Fn fn) {
+    ThreadPool& pool = ThreadPool::instance();
+    size_t n = boids.size();
+    // ~4 slices per thread so stealing can even out dense regions
+    size_t grain = std::max<size_t>(64, n / (pool.size() * 4));
+    pool.parallel_for(0, n, grain, [&fn](size_t start, size_t end) { fn((int)start, (int)end); });
+}
+
+void update_boids(float dt) {
+    TRACE_SCOPE("step");
+    begin_step();
+    {
+        TRACE_SCOPE("forces-pass");
+        run_on_threads([](int start, int end) {
+            TRACE_SCOPE("forces");
+            compute_forces_range(start, end);
+        });
+    }
+    {
+        TRACE_SCOPE("integrate-pass");
+        run_on_threads([dt](int start, int end) {
+            TRACE_SCOPE("integrate");
+            integrate_range(start, end, dt);
+        });
+    }
+    swap_state_buffers();
+    publish_positions();
+}
+
+int get_pool_threads() {
+    return (int)ThreadPool::instance().size();
 }
 
 // --- OPTION B: OpenMP (Runtime Managed) ---
 // The compiler handles the threading logic automatically
+int get_openmp_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// --- OpenMP Scheduling Policy ---
+// The force loop runs schedule(runtime) with the current policy, so
+// autotune_openmp() can switch schedule kind, chunk size and team size without
+// rebuilding. The integration loop does uniform work per block and stays
+// static. Defaults match the old hard-coded clauses.
+enum OmpScheduleKind {
+    OMP_SCHEDULE_STATIC = 0,
+    OMP_SCHEDULE_DYNAMIC = 1,
+    OMP_SCHEDULE_GUIDED = 2
+};
+
+struct OmpPolicy {
+    int kind = OMP_SCHEDULE_DYNAMIC;
+    int chunk = 64;     // 0 = the runtime's default for `kind`
+    int threads = 0;    // Team size, 0 = get_openmp_threads()
+};
+OmpPolicy omp_policy;
+
+int omp_team_size(const OmpPolicy& p) {
+    return p.threads > 0 ? p.threads : get_openmp_threads();
+}
+
+// run-sched-var is per thread, so set it on whichever thread opens the region
+// (the main thread, a pthread-proxied main, or the simulation thread)
+void apply_omp_schedule(const OmpPolicy& p) {
+#ifdef _OPENMP
+    omp_sched_t kind = p.kind == OMP_SCHEDULE_STATIC ? omp_sched_static
+                     : p.kind == OMP_SCHEDULE_GUIDED ? omp_sched_guided : omp_sched_dynamic;
+    omp_set_schedule(kind, p.chunk);
+#else
+    (void)p;
+#endif
+}
+
+std::string describe_omp_policy(const OmpPolicy& p) {
+    static const char* kinds[] = {"static", "dynamic", "guided"};
+    std::string s = kinds[std::max(0, std::min(2, p.kind))];
+    if (p.chunk > 0) s += "," + std::to_string(p.chunk);
+    return s + " x" + std::to_string(omp_team_size(p));
+}
+
+void set_openmp_policy(int kind, int chunk, int threads) {
+    omp_policy.kind = std::max(0, std::min(2, kind));
+    omp_policy.chunk = std::max(0, chunk);
+    omp_policy.threads = std::max(0, threads);
+}
+
+std::string get_openmp_policy() {
+    return describe_omp_policy(omp_policy);
+}
+
+// --- Per-Thread Busy Time ---
+// Each team member adds the time it spends inside the force and integration
+// loops (not waiting at barriers) to its own slot; the spread across slots is
+// the load imbalance the schedule leaves. Slots are cache-line padded and
+// fixed, so recording never allocates.
+const int OMP_MAX_TRACKED_THREADS = 64;
+
+struct alignas(64) ThreadBusy {
+    double ms = 0.0;
+};
+ThreadBusy omp_busy[OMP_MAX_TRACKED_THREADS];
+
+inline void record_busy(double start_ms) {
+#ifdef _OPENMP
+    int t = omp_get_thread_num();
+#else
+    int t = 0;
+#endif
+    if (t < OMP_MAX_TRACKED_THREADS) omp_busy[t].ms += emscripten_get_now() - start_ms;
+}
+
+void reset_thread_busy() {
+    for (ThreadBusy& b : omp_busy) b.ms = 0.0;
+}
+
+// Accumulated busy ms of team member `thread` since the last reset
+double get_thread_busy_ms(int thread) {
+    if (thread < 0 || thread >= OMP_MAX_TRACKED_THREADS) return 0.0;
+    return omp_busy[thread].ms;
+}
+
+// Busiest thread / mean over the first `threads` slots (1 = perfectly balanced)
+double get_thread_imbalance(int threads) {
+    threads = std::max(1, std::min(threads, OMP_MAX_TRACKED_THREADS));
+    double total = 0.0, busiest = 0.0;
+    for (int t = 0; t < threads; t++) {
+        total += omp_busy[t].ms;
+        busiest = std::max(busiest, omp_busy[t].ms);
+    }
+    return total > 0.0 ? busiest * threads / total : 1.0;
+}
+
+// 1. Forces. Neighbour counts vary with local density, so the schedule comes
+//    from omp_policy (dynamic by default) rather than a fixed static split.
+void forces_pass_openmp(int threads) {
+    apply_omp_schedule(omp_policy);
+    #pragma omp parallel num_threads(threads)
+    {
+        TRACE_SCOPE("forces");
+        double t0 = emscripten_get_now();
+        #pragma omp for schedule(runtime) nowait
+        for (int i = 0; i < (int)boids.size(); i++) {
+            if (neighbor_mode == NEIGHBOR_BRUTE_FORCE) compute_force_brute(i);
+            else compute_force_grid(i);
+        }
+        record_busy(t0);
+    }
+}
+
+// 2. Integrate, one SIMD-width-aligned block of boids per iteration
+// 'schedule(static)' is usually fastest for predictable loops like this
+void integrate_pass_openmp(float dt, int threads) {
+    const int n = (int)boids.size();
+    const int block = 256;
+    #pragma omp parallel num_threads(threads)
+    {
+        TRACE_SCOPE("integrate");
+        double t0 = emscripten_get_now();
+        #pragma omp for schedule(static) nowait
+        for (int b = 0; b < (n + block - 1) / block; b++) {
+            integrate_range(b * block, std::min(n, (b + 1) * block), dt);
+        }
+        record_busy(t0);
+    }
+}
+
 void update_boids_openmp(float dt) {
-    // 1. Parallel Update
-    // 'schedule(static)' is usually fastest for predictable loops like this
-    #pragma omp parallel for schedule(static)
-    for (int i = 0; i < (int)boids.size(); i++) {
-        boids[i].x += boids[i].vx * dt;
-        boids[i].y += boids[i].vy * dt;
+    TRACE_SCOPE("step");
+    begin_step();
+    int threads = omp_team_size(omp_policy);
+    forces_pass_openmp(threads);
+    integrate_pass_openmp(dt, threads);
+    swap_state_buffers();
+    publish_positions();
+}
+
+// --- Batched Stepping ---
+// Runs n_steps substeps inside one OpenMP parallel region: the team is forked
+// once, and the only synchronisation per substep is the barrier after each
+// phase (reorder + grid rebuild -> forces -> integrate -> swap). Called from
+// JS, this also pays the JS->WASM crossing once per batch instead of once per
+// step.
+void step_boids(int n_steps, float dt) {
+    const int n = (int)boids.size();
+    const int block = 256;
+    const int blocks = (n + block - 1) / block;
+
+    apply_omp_schedule(omp_policy);
+    #pragma omp parallel num_threads(omp_team_size(omp_policy))
+    {
+        for (int s = 0; s < n_steps; s++) {
+            #pragma omp single
+            begin_step();
 
-        // Bounce
-        if(boids[i].x < 0 || boids[i].x > WIDTH) boids[i].vx *= -1;
-        if(boids[i].y < 0 || boids[i].y > HEIGHT) boids[i].vy *= -1;
+            {
+                TRACE_SCOPE("forces");
+                double t0 = emscripten_get_now();
+                #pragma omp for schedule(runtime) nowait
+                for (int i = 0; i < n; i++) {
+                    if (neighbor_mode == NEIGHBOR_BRUTE_FORCE) compute_force_brute(i);
+                    else compute_force_grid(i);
+                }
+                record_busy(t0);
+            }
+            {
+                TRACE_SCOPE("barrier");
+                #pragma omp barrier
+            }
+
+            {
+                TRACE_SCOPE("integrate");
+                double t0 = emscripten_get_now();
+                #pragma omp for schedule(static) nowait
+                for (int b = 0; b < blocks; b++) {
+                    integrate_range(b * block, std::min(n, (b + 1) * block), dt);
+                }
+                record_busy(t0);
+            }
+            {
+                TRACE_SCOPE("barrier");
+                #pragma omp barrier
+            }
+
+            #pragma omp single
+            swap_state_buffers();
+        }
     }
+
+    publish_positions();
+}
+
+// --- Benchmark Helpers ---
+// Every repetition restores `start` (and the handle order and reorder step
+// count at entry) and times run_steps(), which advances it `steps` steps, so
+// reps are independent and the final state is the same as a single run from
+// `start`. Samples are ms per step.
+BenchConfig swarm_bench_config;
+
+template <typename Fn>
+BenchReport bench_swarm(const char* name, const BoidSoA& start, int steps, Fn run_steps) {
+    BenchConfig cfg = swarm_bench_config;
+    cfg.unit = "ms/step";
+    cfg.ops_per_rep = (double)start.size(); // Boid updates per second
+    BoidOrder start_order = boid_order;
+    return bench_run(name, [&](BenchContext&) {
+        boids = start;
+        boid_order = start_order;
+        return bench_time_ms(run_steps) / std::max(1, steps);
+    }, cfg);
+}
+
+// Ratio of medians, baseline / candidate (> 1 means the candidate is faster)
+double bench_speedup(const BenchReport& baseline, const BenchReport& candidate) {
+    return candidate.stats.median > 0.0 ? baseline.stats.median / candidate.stats.median : 0.0;
+}
+
+// --- Fixed-Timestep Accumulator ---
+// advance_boids(wall_dt) banks real elapsed time and consumes it in whole
+// fixed_dt substeps (one step_boids batch), so simulation results don't depend
+// on the caller's frame rate. Leftover time carries into the next call; the
+// renderer can use get_interpolation_alpha() to blend between the last two states.
+float fixed_dt = 1.0f / 60.0f;
+int max_substeps = 8;     // Per call; excess time is dropped to avoid a spiral of death
+double accumulator = 0.0;
+
+void set_fixed_timestep(float dt, int max_steps_per_call) {
+    fixed_dt = dt > 0.0f ? dt : 1.0f / 60.0f;
+    max_substeps = std::max(1, max_steps_per_call);
+    accumulator = 0.0;
+}
+
+// Returns the number of substeps that were run
+int advance_boids(float wall_dt) {
+    accumulator += std::max(0.0f, wall_dt);
+    int steps = (int)(accumulator / fixed_dt);
+    if (steps > max_substeps) {
+        steps = max_substeps;
+        accumulator = 0.0;
+    } else {
+        accumulator -= steps * (double)fixed_dt;
+    }
+    if (steps > 0) step_boids(steps, fixed_dt);
+    return steps;
+}
+
+float get_interpolation_alpha() {
+    return (float)(accumulator / fixed_dt);
+}
+
+// Times `steps` individual update_boids_openmp calls against one
+// step_boids(steps) batch from the same state. Prints both per-step costs and
+// returns the ratio of medians, per_step / batched.
+double benchmark_step_batching(int steps, float dt) {
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+    BenchReport per_step = bench_swarm("swarm/per-step", start_state, steps, [&] {
+        for (int s = 0; s < steps; s++) update_boids_openmp(dt);
+    });
+    BenchReport batched = bench_swarm("swarm/batched", start_state, steps, [&] { step_boids(steps, dt); });
+    boids = start_state;
+    boid_order = start_order;
+
+    bench_print(per_step);
+    bench_print(batched);
+    return bench_speedup(per_step, batched);
+}
+
+// --- Background Simulation Thread ---
+// Steps the swarm at a fixed rate on its own pthread and publishes every step
+// through render_positions, so the render loop never waits on the simulation.
+// Don't call the update_* functions from JS while it is running.
+std::thread sim_thread;
+std::atomic<bool> sim_running(false);
+std::atomic<uint32_t> sim_steps(0);
+
+void stop_simulation_thread() {
+    if (!sim_running.exchange(false)) return;
+    if (sim_thread.joinable()) sim_thread.join();
+}
+
+void start_simulation_thread(float dt, float steps_per_second, bool use_openmp) {
+    stop_simulation_thread();
+    if (!position_export_enabled) enable_position_export(true);
+    sim_running.store(true);
+    sim_steps.store(0);
+    sim_thread = std::thread([dt, steps_per_second, use_openmp]() {
+        trace_set_thread_name("simulation");
+        double period = steps_per_second > 0.0f ? 1000.0 / steps_per_second : 0.0;
+        double next = emscripten_get_now();
+        while (sim_running.load()) {
+            if (use_openmp) update_boids_openmp(dt);
+            else update_boids(dt);
+            sim_steps.fetch_add(1);
+
+            if (period > 0.0) {
+                next += period;
+                double wait = next - emscripten_get_now();
+                if (wait > 0.0) std::this_thread::sleep_for(std::chrono::microseconds((long long)(wait * 1000.0)));
+                else next = emscripten_get_now(); // Fell behind; don't try to catch up
+            }
+        }
+    });
+}
+
+int get_simulation_steps() {
+    return (int)sim_steps.load();
+}
+
+// --- Grid vs Brute-Force Comparison ---
+// Computes forces for the current state with both strategies and returns the
+// largest per-component difference. Should be ~0 (float summation order only).
+double validate_neighbor_grid() {
+    int saved_mode = neighbor_mode;
+    std::vector<float> ref(boids.size() * 2);
+
+    neighbor_mode = NEIGHBOR_BRUTE_FORCE;
+    compute_forces_range(0, (int)boids.size());
+    for (size_t i = 0; i < boids.size(); i++) {
+        ref[2 * i] = boids.ax[i];
+        ref[2 * i + 1] = boids.ay[i];
+    }
+
+    neighbor_mode = NEIGHBOR_GRID;
+    prepare_neighbor_search();
+    compute_forces_range(0, (int)boids.size());
+    double max_err = 0.0;
+    for (size_t i = 0; i < boids.size(); i++) {
+        max_err = std::max(max_err, (double)std::fabs(boids.ax[i] - ref[2 * i]));
+        max_err = std::max(max_err, (double)std::fabs(boids.ay[i] - ref[2 * i + 1]));
+    }
+
+    neighbor_mode = saved_mode;
+    return max_err;
+}
+
+// Times `steps` OpenMP updates in each mode from the same starting state and
+// returns the grid speedup (brute / grid medians). State is restored afterwards.
+double benchmark_neighbor_modes(int steps, float dt) {
+    int saved_mode = neighbor_mode;
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+    auto run = [&] {
+        for (int s = 0; s < steps; s++) update_boids_openmp(dt);
+    };
+
+    neighbor_mode = NEIGHBOR_GRID;
+    BenchReport grid_run = bench_swarm("swarm/grid", start_state, steps, run);
+    neighbor_mode = NEIGHBOR_BRUTE_FORCE;
+    BenchReport brute_run = bench_swarm("swarm/brute-force", start_state, steps, run);
+
+    boids = start_state;
+    boid_order = start_order;
+    neighbor_mode = saved_mode;
+
+    bench_print(grid_run);
+    bench_print(brute_run);
+    return bench_speedup(brute_run, grid_run);
+}
+
+// Times `steps` full updates through the thread pool and through OpenMP from
+// the same state and returns pool / openmp medians (< 1 means the pool wins).
+double benchmark_pool_vs_openmp(int steps, float dt) {
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+    BenchReport pool_run = bench_swarm("swarm/pool", start_state, steps, [&] {
+        for (int s = 0; s < steps; s++) update_boids(dt);
+    });
+    BenchReport omp_run = bench_swarm("swarm/openmp", start_state, steps, [&] {
+        for (int s = 0; s < steps; s++) update_boids_openmp(dt);
+    });
+    boids = start_state;
+    boid_order = start_order;
+
+    std::cout << "[Swarm] pool threads: " << get_pool_threads() << std::endl;
+    bench_print(pool_run);
+    bench_print(omp_run);
+    return bench_speedup(pool_run, omp_run);
+}
+
+// Times `steps` integration passes with the scalar and the SIMD kernel from the
+// same state and returns the SIMD speedup (scalar / SIMD medians). Forces are
+// computed once up front so only the integration kernel is measured.
+double benchmark_simd_integration(int steps, float dt) {
+    bool saved = simd_enabled;
+    prepare_neighbor_search();
+    compute_forces_range(0, (int)boids.size());
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+    auto run = [&] {
+        for (int s = 0; s < steps; s++) {
+            integrate_range(0, (int)boids.size(), dt);
+            swap_state_buffers();
+        }
+    };
+
+    simd_enabled = false;
+    BenchReport scalar_run = bench_swarm("swarm/integrate-scalar", start_state, steps, run);
+    simd_enabled = true;
+    std::string simd_name = "swarm/integrate-simd" + std::to_string(SWARM_SIMD_WIDTH);
+    BenchReport simd_run = bench_swarm(simd_name.c_str(), start_state, steps, run);
+
+    boids = start_state;
+    boid_order = start_order;
+    simd_enabled = saved;
+
+    bench_print(scalar_run);
+    bench_print(simd_run);
+    return bench_speedup(scalar_run, simd_run);
+}
+
+// Times each phase of a step in isolation on the current state: grid rebuild,
+// then forces and integration through OpenMP at 1, 2, 4, ... threads up to
+// get_openmp_threads(). Double buffering makes every phase a pure function of
+// `boids`, so reps need no restore and the passes can be timed separately.
+// Prints the speedup and parallel efficiency of each thread count against one
+// thread, and returns the summed phase medians at the highest count (ms/step).
+double benchmark_step_phases(float dt) {
+    boids_next.resize(boids.size());
+    BenchConfig cfg = swarm_bench_config;
+    cfg.ops_per_rep = (double)boids.size(); // Boid updates per second
+
+    BenchReport rebuild = bench_run_timed("swarm/phase/rebuild", [] { prepare_neighbor_search(); }, cfg);
+    bench_print(rebuild);
+
+    std::vector<int> counts;
+    for (int t = 1; t < get_openmp_threads(); t *= 2) counts.push_back(t);
+    counts.push_back(get_openmp_threads());
+
+    double forces_one = 0.0, integrate_one = 0.0, step_ms = 0.0;
+    for (int t : counts) {
+        std::string suffix = "-" + std::to_string(t) + "t";
+        BenchReport forces = bench_run_timed(("swarm/phase/forces" + suffix).c_str(),
+                                             [t] { forces_pass_openmp(t); }, cfg);
+        BenchReport integrate = bench_run_timed(("swarm/phase/integrate" + suffix).c_str(),
+                                                [t, dt] { integrate_pass_openmp(dt, t); }, cfg);
+        bench_print(forces);
+        bench_print(integrate);
+        if (t == 1) {
+            forces_one = forces.stats.median;
+            integrate_one = integrate.stats.median;
+        }
+        double forces_speedup = forces_one / std::max(1e-9, forces.stats.median);
+        double integrate_speedup = integrate_one / std::max(1e-9, integrate.stats.median);
+        std::printf("[Swarm] %d thread(s): forces %.2fx (%.0f%% efficiency), integrate %.2fx (%.0f%%)\n", t,
+                    forces_speedup, 100.0 * forces_speedup / t, integrate_speedup, 100.0 * integrate_speedup / t);
+        step_ms = rebuild.stats.median + forces.stats.median + integrate.stats.median;
+    }
+    std::fflush(stdout);
+    return step_ms;
+}
+
+// --- OpenMP Autotuning ---
+// Tuned policies are keyed by (boid count rounded up to a power of two,
+// hardware threads), so one table can travel between machines and sizes.
+// get_openmp_tuning() / load_openmp_tuning() move it in and out as text, one
+// "<boids> <cores> <kind> <chunk> <threads>" line per entry: the CLI keeps it
+// in a file (--tune-file), a page can keep it in localStorage.
+const int AUTOTUNE_WARMUP_STEPS = 2;
+
+std::map<std::pair<int, int>, OmpPolicy> omp_tuning_table;
+
+int hardware_cores() {
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+std::pair<int, int> omp_tuning_key(int count) {
+    int bucket = 1;
+    while (bucket < count) bucket <<= 1;
+    return std::make_pair(bucket, hardware_cores());
+}
+
+void select_tuned_openmp_policy(int count) {
+    auto it = omp_tuning_table.find(omp_tuning_key(count));
+    if (it != omp_tuning_table.end()) omp_policy = it->second;
+}
+
+std::string get_openmp_tuning() {
+    std::ostringstream out;
+    for (const auto& entry : omp_tuning_table) {
+        const OmpPolicy& p = entry.second;
+        out << entry.first.first << " " << entry.first.second << " "
+            << p.kind << " " << p.chunk << " " << p.threads << "\n";
+    }
+    return out.str();
+}
+
+// Merges entries from get_openmp_tuning() text (malformed lines are skipped),
+// applies the one for the current boid count and returns how many were read
+int load_openmp_tuning(const std::string& text) {
+    std::istringstream in(text);
+    std::string line;
+    int loaded = 0;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        int bucket, cores;
+        OmpPolicy p;
+        if (!(fields >> bucket >> cores >> p.kind >> p.chunk >> p.threads)) continue;
+        if (p.kind < OMP_SCHEDULE_STATIC || p.kind > OMP_SCHEDULE_GUIDED || p.chunk < 0 || p.threads < 0) continue;
+        omp_tuning_table[std::make_pair(bucket, cores)] = p;
+        loaded++;
+    }
+    select_tuned_openmp_policy((int)boids.size());
+    return loaded;
+}
+
+// Runs `steps` OpenMP updates (after a short warm-up) from the current state
+// for every schedule kind x chunk size x team size (1, 2, 4, ... up to
+// get_openmp_threads()), each from the same snapshot, and keeps the policy
+// with the lowest median ms/step. The winner becomes omp_policy and is stored
+// in the tuning table for this (boid count, cores) key. Boid state is restored
+// afterwards. Returns the chosen policy, e.g. "guided,16 x8".
+std::string autotune_openmp(int steps, float dt) {
+    steps = std::max(1, steps);
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+
+    std::vector<int> teams;
+    for (int t = 1; t < get_openmp_threads(); t *= 2) teams.push_back(t);
+    teams.push_back(get_openmp_threads());
+    static const int kinds[] = {OMP_SCHEDULE_STATIC, OMP_SCHEDULE_DYNAMIC, OMP_SCHEDULE_GUIDED};
+    static const int chunks[] = {0, 16, 64, 256};
+
+    OmpPolicy best = omp_policy;
+    double best_ms = 0.0;
+    std::vector<double> samples;
+    for (int kind : kinds) {
+        for (int chunk : chunks) {
+            for (int team : teams) {
+                omp_policy.kind = kind;
+                omp_policy.chunk = chunk;
+                omp_policy.threads = team;
+                boids = start_state;
+                boid_order = start_order;
+                for (int w = 0; w < AUTOTUNE_WARMUP_STEPS; w++) update_boids_openmp(dt);
+                samples.clear();
+                for (int s = 0; s < steps; s++) samples.push_back(bench_time_ms([dt] { update_boids_openmp(dt); }));
+                double ms = bench_compute_stats(samples).median;
+                std::printf("[Swarm] autotune %-16s %.4f ms/step\n", describe_omp_policy(omp_policy).c_str(), ms);
+                if (best_ms == 0.0 || ms < best_ms) {
+                    best = omp_policy;
+                    best_ms = ms;
+                }
+            }
+        }
+    }
+
+    // Busy time per thread under the winner, for the load-balance report
+    omp_policy = best;
+    boids = start_state;
+    boid_order = start_order;
+    reset_thread_busy();
+    for (int s = 0; s < steps; s++) update_boids_openmp(dt);
+    int team = omp_team_size(best);
+    std::printf("[Swarm] autotune picked %s: %.4f ms/step, busy ms per thread:", describe_omp_policy(best).c_str(), best_ms);
+    for (int t = 0; t < std::min(team, OMP_MAX_TRACKED_THREADS); t++) std::printf(" %.1f", get_thread_busy_ms(t));
+    std::printf(" (imbalance %.3f)\n", get_thread_imbalance(team));
+    std::printf("RESULT: {\"name\":\"swarm/autotune\",\"policy\":\"%s\",\"msPerStep\":%.6g,\"boids\":%d,"
+                "\"cores\":%d,\"imbalance\":%.6g}\n",
+                describe_omp_policy(best).c_str(), best_ms, (int)start_state.size(), hardware_cores(),
+                get_thread_imbalance(team));
+    std::fflush(stdout);
+
+    boids = start_state;
+    boid_order = start_order;
+    omp_tuning_table[omp_tuning_key((int)boids.size())] = best;
+    return describe_omp_policy(best);
+}
+
+// Candidate boids the grid force pass visits for the current grid: every boid
+// scans the boids of its 3x3 cell block
+double count_neighbor_visits() {
+    double visits = 0.0;
+    for (int cy = 0; cy < grid.rows; cy++) {
+        for (int cx = 0; cx < grid.cols; cx++) {
+            int c = cy * grid.cols + cx;
+            int own = grid.cell_start[c + 1] - grid.cell_start[c];
+            if (own == 0) continue;
+            int block = 0;
+            for (int y = std::max(0, cy - 1); y <= std::min(grid.rows - 1, cy + 1); y++) {
+                for (int x = std::max(0, cx - 1); x <= std::min(grid.cols - 1, cx + 1); x++) {
+                    block += grid.cell_start[y * grid.cols + x + 1] - grid.cell_start[y * grid.cols + x];
+                }
+            }
+            visits += (double)own * block;
+        }
+    }
+    return visits;
+}
+
+// Times the grid force pass (rebuild + forces on the pool) in the current
+// order and after a Morton reorder, as ns per neighbour visit. The arithmetic
+// per visit is identical, so the difference is a proxy for cache misses. Then
+// times `steps` full pool updates with reordering off and at reorder_interval
+// (REORDER_DEFAULT_INTERVAL if off). Returns the force-pass speedup (current
+// order / Morton medians). State is restored afterwards.
+double benchmark_reorder(int steps, float dt) {
+    int saved_mode = neighbor_mode;
+    int saved_interval = reorder_interval;
+    neighbor_mode = NEIGHBOR_GRID;
+    BoidSoA start_state = boids;
+    BoidOrder start_order = boid_order;
+
+    auto force_pass = [] {
+        prepare_neighbor_search();
+        run_on_threads([](int start, int end) { compute_forces_range(start, end); });
+    };
+    prepare_neighbor_search();
+    BenchConfig cfg = swarm_bench_config;
+    cfg.ops_per_rep = count_neighbor_visits(); // Neighbour visits per second
+    BenchReport unordered = bench_run_timed("swarm/forces-unordered", force_pass, cfg);
+
+    BenchReport sort_run = bench_run("swarm/reorder", [&](BenchContext&) {
+        boids = start_state;
+        boid_order = start_order;
+        return bench_time_ms(reorder_boids);
+    }, swarm_bench_config);
+    BenchReport ordered = bench_run_timed("swarm/forces-morton", force_pass, cfg);
+
+    auto run = [&] {
+        for (int s = 0; s < steps; s++) update_boids(dt);
+    };
+    int interval = saved_interval > 0 ? saved_interval : REORDER_DEFAULT_INTERVAL;
+    reorder_interval = 0;
+    boid_order = start_order;
+    BenchReport off_run = bench_swarm("swarm/reorder-off", start_state, steps, run);
+    reorder_interval = interval;
+    std::string on_name = "swarm/reorder-every-" + std::to_string(interval);
+    BenchReport on_run = bench_swarm(on_name.c_str(), start_state, steps, run);
+
+    boids = start_state;
+    boid_order = start_order;
+    reorder_interval = saved_interval;
+    neighbor_mode = saved_mode;
+
+    bench_print(unordered);
+    bench_print(ordered);
+    bench_print(sort_run);
+    bench_print(off_run);
+    bench_print(on_run);
+    auto ns_per_visit = [&cfg](const BenchReport& r) { return r.stats.median * 1e6 / std::max(1.0, cfg.ops_per_rep); };
+    std::cout << "[Swarm] " << cfg.ops_per_rep / (double)std::max<size_t>(1, start_state.size())
+              << " neighbour visits/boid; ns per visit: unordered " << ns_per_visit(unordered)
+              << ", Morton " << ns_per_visit(ordered) << "; reorder " << sort_run.stats.median << " ms" << std::endl;
+    std::cout << "[Swarm] full step, reorder every " << interval << ": " << bench_speedup(off_run, on_run)
+              << "x vs never" << std::endl;
+    return bench_speedup(unordered, ordered);
+}
+
+// One-call validation run: seed, step with the batched path, checksum
+std::string run_checksum(int count, uint32_t seed, int steps, float dt) {
+    init_boids_seeded(count, seed);
+    step_boids(steps, dt);
+    return swarm_checksum();
 }
 
 // Bindings
 EMSCRIPTEN_BINDINGS(my_module) {
     function("init_boids", &init_boids);
+    function("init_boids_seeded", &init_boids_seeded);     // Deterministic (count, seed)
+    function("swarm_checksum", &swarm_checksum);           // Order-independent, hex string
+    function("run_checksum", &run_checksum);               // (count, seed, steps, dt) -> checksum
     function("update_boids", &update_boids);       // Call for "WASM + Threads"
+    function("get_pool_threads", &get_pool_threads);
+    function("benchmark_pool_vs_openmp", &benchmark_pool_vs_openmp);
     function("update_boids_openmp", &update_boids_openmp); // Call for "WASM + OpenMP"
+    function("step_boids", &step_boids);                   // n_steps in one parallel region
+    function("set_fixed_timestep", &set_fixed_timestep);
+    function("advance_boids", &advance_boids);             // Wall-clock delta -> fixed substeps
+    function("get_interpolation_alpha", &get_interpolation_alpha);
+    function("benchmark_step_batching", &benchmark_step_batching);
+    function("set_neighbor_mode", &set_neighbor_mode);     // 0 = spatial grid, 1 = brute force
+    function("get_neighbor_mode", &get_neighbor_mode);
+    function("validate_neighbor_grid", &validate_neighbor_grid);
+    function("benchmark_neighbor_modes", &benchmark_neighbor_modes);
+    function("set_simd_enabled", &set_simd_enabled);       // A/B: false = scalar integration kernel
+    function("get_simd_enabled", &get_simd_enabled);
+    function("get_simd_width", &get_simd_width);
+    function("benchmark_simd_integration", &benchmark_simd_integration);
+    function("benchmark_step_phases", &benchmark_step_phases); // Per-phase ms, thread scaling
+    function("get_openmp_threads", &get_openmp_threads);
+    function("set_openmp_policy", &set_openmp_policy);    // (kind 0 static | 1 dynamic | 2 guided, chunk, threads)
+    function("get_openmp_policy", &get_openmp_policy);
+    function("autotune_openmp", &autotune_openmp);        // (steps per candidate, dt) -> chosen policy
+    function("get_openmp_tuning", &get_openmp_tuning);    // Persist this string...
+    function("load_openmp_tuning", &load_openmp_tuning);  // ...and hand it back on the next load
+    function("get_thread_busy_ms", &get_thread_busy_ms);
+    function("get_thread_imbalance", &get_thread_imbalance);
+    function("reset_thread_busy", &reset_thread_busy);
+    function("set_trace_enabled", &trace_enable);         // Per-thread timeline (common/trace.h)
+    function("get_trace_json", &trace_json);              // Chrome trace-event JSON for Perfetto
+    function("reset_trace", &trace_reset);
+    function("set_reorder_interval", &set_reorder_interval); // Morton reorder every N steps, 0 = off
+    function("get_reorder_interval", &get_reorder_interval);
+    function("reorder_boids", &reorder_boids);             // Reorder now
+    function("get_boid_slot", &get_boid_slot);             // Stable handle -> current slot
+    function("benchmark_reorder", &benchmark_reorder);
+    function("enable_position_export", &enable_position_export);
+    function("acquire_positions", &acquire_positions);     // Once per render frame -> buffer index
+    function("get_positions_frame", &get_positions_frame);
+    function("get_positions_view", &get_positions_view);   // Cache the 3 views once
+    function("get_positions_ptr", &get_positions_ptr);
+    function("start_simulation_thread", &start_simulation_thread);
+    function("stop_simulation_thread", &stop_simulation_thread);
+    function("get_simulation_steps", &get_simulation_steps);
 }
 
-// Entry point (required for linking)
-int main() {
+// --- Command-Line Harness ---
+// The browser build is driven through the bindings above. Given arguments
+// (native builds, or Module.arguments in the browser) main runs a standalone
+// timing pass of each update path from the same seeded state instead.
+//
+//   swarm [--boids N] [--steps S] [--dt DT] [--seed SEED] [--mode all|pool|openmp|batched|phases|reorder|tune]
+//         [--reorder N] [--tune-file PATH] [--trace PATH] [--brute] [--scalar] [--rme FRACTION]
+//         [--max-time MS]
+//
+// --mode tune runs autotune_openmp with --steps steps per candidate and, with
+// --tune-file, saves the table there; other modes load it from that file.
+// --trace writes a Chrome trace of every thread (common/trace.h) on exit.
+// Every update path must reach the same checksum: with --mode all, each
+// path's checksum is compared with the first one's, and a mismatch is
+// reported as MISMATCH and makes the exit status non-zero.
+int run_cli(int argc, char** argv) {
+    int count = NUM_BOIDS;
+    int steps = 200;
+    float dt = 0.016f;
+    uint32_t seed = DEFAULT_SEED;
+    std::string mode = "all";
+    const char* tune_path = nullptr;
+    const char* trace_path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--boids" && has_value) count = std::atoi(argv[++i]);
+        else if (arg == "--steps" && has_value) steps = std::atoi(argv[++i]);
+        else if (arg == "--dt" && has_value) dt = (float)std::atof(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+        else if (arg == "--mode" && has_value) mode = argv[++i];
+        else if (arg == "--reorder" && has_value) set_reorder_interval(std::atoi(argv[++i]));
+        else if (arg == "--tune-file" && has_value) tune_path = argv[++i];
+        else if (arg == "--trace" && has_value) trace_path = argv[++i];
+        else if (arg == "--brute") set_neighbor_mode(NEIGHBOR_BRUTE_FORCE);
+        else if (arg == "--scalar") set_simd_enabled(false);
+        else if (arg == "--rme" && has_value) swarm_bench_config.target_rme = std::atof(argv[++i]);
+        else if (arg == "--max-time" && has_value) swarm_bench_config.max_time_ms = std::atof(argv[++i]);
+        else {
+            std::cout << "usage: swarm [--boids N] [--steps S] [--dt DT] [--seed SEED] "
+                         "[--mode all|pool|openmp|batched|phases|reorder|tune] [--reorder N] [--tune-file PATH] "
+                         "[--trace PATH] [--brute] [--scalar] [--rme FRACTION] [--max-time MS]" << std::endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::cout << "--- SWARM: " << count << " boids, " << steps << " steps, "
+              << (neighbor_mode == NEIGHBOR_GRID ? "grid" : "brute force") << ", "
+              << (get_simd_enabled() ? "SIMD" : "scalar") << " integration, reorder "
+              << (reorder_interval > 0 ? "every " + std::to_string(reorder_interval) + " steps" : std::string("off"))
+              << " ---" << std::endl;
+    // Chrome trace of every thread, written when run_cli returns
+    TraceSession trace(trace_path);
+
+    if (tune_path) {
+        std::ifstream in(tune_path);
+        std::stringstream text;
+        text << in.rdbuf();
+        if (in) std::cout << "[Swarm] loaded " << load_openmp_tuning(text.str()) << " tuned policies from " << tune_path << std::endl;
+    }
+
+    if (mode == "tune") {
+        init_boids_seeded(count, seed);
+        std::string policy = autotune_openmp(steps, dt);
+        if (tune_path) {
+            std::ofstream out(tune_path);
+            out << get_openmp_tuning();
+            std::cout << "[Swarm] saved tuned policies to " << tune_path << std::endl;
+        }
+        std::cout << "[Swarm] OpenMP policy for " << count << " boids: " << policy << std::endl;
+        return 0;
+    }
+    if (mode == "phases") {
+        init_boids_seeded(count, seed);
+        double step_ms = benchmark_step_phases(dt);
+        std::cout << "[Swarm] one step from phases: " << step_ms << " ms" << std::endl;
+        return 0;
+    }
+    if (mode == "reorder") {
+        init_boids_seeded(count, seed);
+        double speedup = benchmark_reorder(steps, dt);
+        std::cout << "[Swarm] Morton force-pass speedup: " << speedup << "x" << std::endl;
+        return 0;
+    }
+
+    const char* modes[] = {"pool", "openmp", "batched"};
+    const char* reference_mode = nullptr;
+    std::string reference_checksum;
+    int mismatches = 0;
+    for (const char* m : modes) {
+        if (mode != "all" && mode != m) continue;
+        init_boids_seeded(count, seed);
+        BoidSoA start_state = boids;
+        std::string name = std::string("swarm/") + m;
+        bool batched = name == "swarm/batched";
+        bool pool = name == "swarm/pool";
+        reset_thread_busy();
+        BenchReport report = bench_swarm(name.c_str(), start_state, steps, [&] {
+            if (batched) {
+                step_boids(steps, dt);
+                return;
+            }
+            for (int s = 0; s < steps; s++) {
+                if (pool) update_boids(dt);
+                else update_boids_openmp(dt);
+            }
+        });
+        bench_print(report);
+        // Each repetition restarts from the seeded state, so this is the
+        // checksum of exactly `steps` steps
+        std::string checksum = swarm_checksum();
+        std::cout << "[Swarm] " << m << " checksum " << checksum;
+        if (!reference_mode) {
+            reference_mode = m;
+            reference_checksum = checksum;
+        } else if (checksum == reference_checksum) {
+            std::cout << " ok (matches " << reference_mode << ")";
+        } else {
+            std::cout << " MISMATCH (" << reference_mode << " " << reference_checksum << ")";
+            mismatches++;
+        }
+        std::cout << std::endl;
+        if (!pool) {
+            std::cout << "[Swarm] " << m << " policy " << get_openmp_policy() << ", thread busy imbalance "
+                      << get_thread_imbalance(omp_team_size(omp_policy)) << std::endl;
+        }
+        alloc_probe(name.c_str(), std::min(steps, 50), "step", [&] {
+            if (batched) step_boids(1, dt);
+            else if (pool) update_boids(dt);
+            else update_boids_openmp(dt);
+        });
+    }
+
+    if (mode == "all") {
+        init_boids_seeded(count, seed);
+        std::cout << "[Swarm] grid vs brute-force max force error: " << validate_neighbor_grid() << std::endl;
+    }
+    if (mismatches > 0) {
+        std::cout << "[Swarm] " << mismatches << " update path(s) diverged from " << reference_mode << std::endl;
+        return 1;
+    }
     return 0;
 }
+
+// Entry point (required for linking)
+int main(int argc, char** argv) {
+    if (argc <= 1) {
+#ifdef __EMSCRIPTEN__
+        return 0;
+#else
+        char* defaults[] = {argv[0], (char*)"--mode", (char*)"all"};
+        return run_cli(3, defaults);
+#endif
+    }
+    return run_cli(argc, argv);
+}
@@ -0,0 +1,173 @@
+// GpuTimer (common/gpu_timer.h) against the native WebGPU stand-in.
+//
+// The stand-in's synthetic GPU clock advances by a fixed cost model (200 ns
+// + 1 ns per 16 bytes for a copy, 500 ns + 4 ns per workgroup for a
+// dispatch), so timestamp-query durations of known work are exact. Run once
+// as is and once with NATIVE_WEBGPU_NO_TIMESTAMPS=1, which hides the feature
+// and exercises the OnSubmittedWorkDone fallback (see CMakeLists.txt).
+// Exits non-zero on any failed check.
+
+#include <emscripten/emscripten.h>
+#include <webgpu/webgpu.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "../common/gpu_timer.h"
+
+const uint64_t COPY_BYTES = 1 << 20;
+const uint32_t WORKGROUPS = 1000;
+const double COPY_MS = (200 + COPY_BYTES / 16) / 1e6;
+const double DISPATCH_MS = (500 + WORKGROUPS * 4) / 1e6;
+
+WGPUDevice device = nullptr;
+WGPUQueue queue = nullptr;
+WGPUBuffer srcBuffer = nullptr;
+WGPUBuffer dstBuffer = nullptr;
+int failures = 0;
+
+void check(bool cond, const char* what) {
+    std::printf("  %-58s %s\n", what, cond ? "ok" : "MISMATCH");
+    if (!cond) failures++;
+}
+
+bool near(double ms, double expected) {
+    return std::fabs(ms - expected) < 1e-9;
+}
+
+void onDeviceRequestEnded(WGPURequestDeviceStatus status, WGPUDevice inDevice, const char*, void*) {
+    if (status != WGPURequestDeviceStatus_Success) return;
+    device = inDevice;
+    queue = wgpuDeviceGetQueue(device);
+}
+
+void onAdapterRequestEnded(WGPURequestAdapterStatus status, WGPUAdapter adapter, const char*, void*) {
+    if (status != WGPURequestAdapterStatus_Success) return;
+    WGPUDeviceDescriptor deviceDesc = {};
+    gpu_timer_request_features(adapter, deviceDesc);
+    wgpuAdapterRequestDevice(adapter, &deviceDesc, onDeviceRequestEnded, nullptr);
+    wgpuAdapterRelease(adapter);
+}
+
+void submit(WGPUCommandEncoder encoder) {
+    WGPUCommandBuffer commands = wgpuCommandEncoderFinish(encoder, nullptr);
+    wgpuQueueSubmit(queue, 1, &commands);
+    wgpuCommandBufferRelease(commands);
+    wgpuCommandEncoderRelease(encoder);
+}
+
+// One COPY_BYTES copy between mark_begin / mark_end in a single encoder
+void submit_marked_copy(GpuTimer& timer) {
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    timer.mark_begin(encoder);
+    wgpuCommandEncoderCopyBufferToBuffer(encoder, srcBuffer, 0, dstBuffer, 0, COPY_BYTES);
+    timer.mark_end(encoder);
+    timer.resolve(encoder);
+    submit(encoder);
+}
+
+void test_timestamps(GpuTimer& timer) {
+    std::printf("[gpu_timer] timestamp-query\n");
+    check(timer.has_timestamps(), "device has timestamp-query");
+
+    submit_marked_copy(timer);
+    GpuTiming t = timer.collect();
+    check(t.ok && t.from_timestamps && near(t.ms, COPY_MS), "marked copy = copy cost");
+
+    WGPUCommandEncoder encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    WGPUComputePassDescriptor passDesc = {};
+    passDesc.timestampWrites = timer.pass_writes();
+    WGPUComputePassEncoder pass = wgpuCommandEncoderBeginComputePass(encoder, &passDesc);
+    wgpuComputePassEncoderDispatchWorkgroups(pass, WORKGROUPS, 1, 1);
+    wgpuComputePassEncoderEnd(pass);
+    wgpuComputePassEncoderRelease(pass);
+    timer.resolve(encoder);
+    submit(encoder);
+    t = timer.collect();
+    check(t.ok && near(t.ms, DISPATCH_MS), "pass timestampWrites = dispatch cost");
+
+    timer.submit_begin();
+    encoder = wgpuDeviceCreateCommandEncoder(device, nullptr);
+    wgpuCommandEncoderCopyBufferToBuffer(encoder, srcBuffer, 0, dstBuffer, 0, COPY_BYTES);
+    submit(encoder);
+    timer.submit_end();
+    t = timer.collect();
+    check(t.ok && near(t.ms, COPY_MS), "submit_begin / submit_end span = copy cost");
+
+    // Timed out, then the late map lands before the next frame
+    submit_marked_copy(timer);
+    check(!timer.collect(0.0).ok && timer.timeouts() == 1, "collect(0) times out");
+    emscripten_sleep(0);
+    submit_marked_copy(timer);
+    t = timer.collect();
+    check(t.ok && near(t.ms, COPY_MS), "next frame after a late map is timed");
+
+    // Timed out, and the map is still pending at the next frame
+    submit_marked_copy(timer);
+    check(!timer.collect(0.0).ok && timer.timeouts() == 2, "collect(0) times out again");
+    submit_marked_copy(timer);
+    t = timer.collect();
+    check(t.ok && near(t.ms, COPY_MS), "next frame with the map still pending is timed");
+    for (int i = 0; i < 3; i++) {
+        submit_marked_copy(timer);
+        t = timer.collect();
+        check(t.ok && near(t.ms, COPY_MS), "later frames are timed");
+    }
+    check(timer.timeouts() == 2, "no further timeouts");
+}
+
+void test_fallback(GpuTimer& timer) {
+    std::printf("[gpu_timer] queue-callback fallback\n");
+    check(!timer.has_timestamps() && timer.pass_writes() == nullptr, "no timestamp-query");
+
+    submit_marked_copy(timer);
+    GpuTiming t = timer.collect();
+    check(t.ok && !t.from_timestamps && t.ms >= 0.0 && t.ms < 1000.0, "work-done callback timed");
+
+    submit_marked_copy(timer);
+    check(!timer.collect(0.0).ok && timer.timeouts() == 1, "collect(0) times out");
+    for (int i = 0; i < 3; i++) {
+        submit_marked_copy(timer);
+        t = timer.collect();
+        check(t.ok && t.ms >= 0.0 && t.ms < 1000.0, "later frames are timed");
+    }
+    check(timer.timeouts() == 1, "no further timeouts");
+}
+
+int main() {
+    WGPUInstanceDescriptor desc = {};
+    WGPUInstance instance = wgpuCreateInstance(&desc);
+    WGPURequestAdapterOptions options = {};
+    wgpuInstanceRequestAdapter(instance, &options, onAdapterRequestEnded, nullptr);
+    for (int i = 0; !device && i < 100; i++) emscripten_sleep(1);
+    if (!device) {
+        std::printf("[gpu_timer] no device\n");
+        return 1;
+    }
+    wgpuInstanceRelease(instance);
+
+    WGPUBufferDescriptor bufDesc = {};
+    bufDesc.size = COPY_BYTES;
+    bufDesc.usage = WGPUBufferUsage_CopySrc;
+    srcBuffer = wgpuDeviceCreateBuffer(device, &bufDesc);
+    bufDesc.usage = WGPUBufferUsage_CopyDst;
+    dstBuffer = wgpuDeviceCreateBuffer(device, &bufDesc);
+
+    const char* noTimestamps = std::getenv("NATIVE_WEBGPU_NO_TIMESTAMPS");
+    bool fallback = noTimestamps && noTimestamps[0] && noTimestamps[0] != '0';
+    {
+        GpuTimer timer;
+        timer.init(device, queue);
+        if (fallback) test_fallback(timer);
+        else test_timestamps(timer);
+    }
+    emscripten_sleep(0); // Deliver any late callbacks before exit
+
+    wgpuBufferRelease(srcBuffer);
+    wgpuBufferRelease(dstBuffer);
+    wgpuQueueRelease(queue);
+    wgpuDeviceRelease(device);
+    std::printf("[gpu_timer] %s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
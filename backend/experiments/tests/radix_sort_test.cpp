@@ -0,0 +1,51 @@
+// radix_sort_pairs (common/radix_sort.h) against std::stable_sort, on
+// multi-thread pools so pool workers (not just the caller) run the histogram
+// and scatter blocks. Exits non-zero on any mismatch.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../common/radix_sort.h"
+
+int failures = 0;
+
+// Sorts `n` random keys masked to `key_mask` (values are the original
+// indices) and compares keys and values with a stable reference sort
+void check_sort(ThreadPool& pool, size_t n, uint32_t key_mask, int key_bits, std::vector<uint32_t>& offsets) {
+    std::mt19937 rng((uint32_t)(n * 2654435761u) ^ key_mask);
+    std::vector<uint32_t> keys(n), vals(n), tmpKeys, tmpVals;
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = rng() & key_mask;
+        vals[i] = (uint32_t)i;
+    }
+
+    std::vector<uint32_t> refVals = vals;
+    std::stable_sort(refVals.begin(), refVals.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    std::vector<uint32_t> refKeys(n);
+    for (size_t i = 0; i < n; i++) refKeys[i] = keys[refVals[i]];
+
+    radix_sort_pairs(keys, vals, tmpKeys, tmpVals, offsets, key_bits, pool);
+    bool ok = keys == refKeys && vals == refVals;
+    std::printf("  %u threads, n=%-8zu mask=%08x  %s\n", pool.size(), n, key_mask, ok ? "ok" : "MISMATCH");
+    if (!ok) failures++;
+}
+
+int main() {
+    const size_t sizes[] = {0, 1, 1000, 100000, 1 << 20};
+    const uint32_t masks[] = {0xFFFFFFFFu, 0x000FFFFFu, 0x0000000Fu};
+    const int maskBits[] = {32, 20, 4};
+
+    std::printf("[radix_sort] vs std::stable_sort\n");
+    for (unsigned threads : {1u, 4u, 8u}) {
+        ThreadPool pool(threads);
+        std::vector<uint32_t> offsets; // Reused across sorts, as callers do
+        for (size_t n : sizes) {
+            for (int m = 0; m < 3; m++) check_sort(pool, n, masks[m], maskBits[m], offsets);
+        }
+    }
+    std::printf("[radix_sort] %s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -78,9 +78,17 @@ async function runWasmBenchmark(wasmModule, configId) {
   } else if (configId.includes('openmp') || configId.includes('threads')) {
     // Threaded (swarm)
     if (wasmModule.init_boids) wasmModule.init_boids(100);
-    for (let i = 0; i < numIterations; i++) {
-      if (wasmModule.update_boids_openmp) wasmModule.update_boids_openmp(0.016);
-      else if (wasmModule.update_boids) wasmModule.update_boids(0.016);
+    if (wasmModule.step_boids) {
+      // Batched: one JS->WASM crossing and one OpenMP fork/join per 100 steps
+      const batch = 100;
+      for (let i = 0; i < numIterations; i += batch) {
+        wasmModule.step_boids(Math.min(batch, numIterations - i), 0.016);
+      }
+    } else {
+      for (let i = 0; i < numIterations; i++) {
+        if (wasmModule.update_boids_openmp) wasmModule.update_boids_openmp(0.016);
+        else if (wasmModule.update_boids) wasmModule.update_boids(0.016);
+      }
     }
   } else {
     // Generic fallback